@@ -1,7 +1,7 @@
 /* 
  * index.c  
  *
- * An index is a hashtable of countersets.
+ * An index is a strpool of words, and an array of countersets indexed by term ID.
  *
  * see index.h for more information.
  *
@@ -10,15 +10,23 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <ctype.h>
+#include <stdbool.h>
 #include "../libcs50/mem.h"
 #include "../libcs50/counters.h"
-#include "../libcs50/hashtable.h"
+#include "../libcs50/strpool.h"
+#include "../libcs50/hash.h"
 #include "../libcs50/file.h"
 
 /**************** global types ****************/
 typedef struct index {
-    hashtable_t *ht;       
+    strpool_t* terms;           //the words, each with its term ID
+    counters_t** postings;      //counterset of each term ID
+    int numTerms;               //term IDs that have a counterset
+    int room;                   //countersets there is room for in postings
+    char* buffer;               //lowercase of the word index_upsert is counting
+    int size;                   //chars allocated for buffer
 } index_t;
 
 /**************** local functions ****************/
@@ -42,7 +50,7 @@ static void index_printCounters(void *arg, const int key, const int count){
 /* 
  * Input: FILE* as arg, char* as key, counters_t* as item.
  *
- * This function is meant to be passed to hashtable_iterate by index_write.
+ * This function is meant to be passed to index_iterate by index_write.
  * Prints the key word for each line, then calls counters_iterate to print the rest.
  * Matches the output format specified for an index file.
  *
@@ -61,6 +69,41 @@ static void index_printLines(void *arg, const char *key, void *item){
     fprintf(fp, "\n");
 }
 
+/**************** index_counters ****************/
+/* 
+ * Input: index_t*, a term ID from interning a word in the index's strpool,
+ *        and bool* to set to whether the word was new to the index.
+ * Returns: the counterset of the term ID, making an empty one first if the word is new,
+ *          or NULL if termID is -1, as strpool gives when out of memory, or there is no memory for it.
+ * A new word's ID is always the number of words before it, so it is the next in postings.
+ */
+static counters_t* index_counters(index_t* index, const int termID, bool* isNew){
+    *isNew = termID == index->numTerms;
+    if(termID < 0){
+        return NULL;
+    }
+    if(!*isNew){
+        return index->postings[termID];
+    }
+    if(index->numTerms == index->room){
+        //grow postings to double, as the strpool grows its own arrays
+        int room = index->room * 2;
+        counters_t** postings = mem_malloc(room * sizeof(counters_t*));
+        if(postings == NULL){
+            return NULL;
+        }
+        memcpy(postings, index->postings, index->numTerms * sizeof(counters_t*));
+        mem_free(index->postings);
+        index->postings = postings;
+        index->room = room;
+    }
+    if((index->postings[termID] = counters_new()) == NULL){
+        return NULL;
+    }
+    index->numTerms++;
+    return index->postings[termID];
+}
+
 /**************** functions ****************/
 
 /**************** index_new ****************/
@@ -69,9 +112,13 @@ index_t* index_new(const int numslots){
     //build index
     index_t* index = mem_malloc_assert(sizeof(index_t), "index");
 
-    //build hashtable for index
-    hashtable_t* ht = mem_assert(hashtable_new(numslots), "index");
-    index->ht = ht;
+    //build strpool for the words, and room for a counterset per word
+    index->terms = mem_assert(strpool_new(numslots), "index");
+    index->postings = mem_malloc_assert(numslots * sizeof(counters_t*), "index");
+    index->numTerms = 0;
+    index->room = numslots;
+    index->buffer = NULL;
+    index->size = 0;
 
     return index;
 }
@@ -79,21 +126,27 @@ index_t* index_new(const int numslots){
 /**************** index_insert ****************/
 /* See index.h for usage documentation */
 bool index_insert(index_t* index, const char* word){
+    int termID;         //term ID of the word
+    bool isNew;         //whether the word was new to the index
 
-    //create a counter set for the given word
-    counters_t* counterset = mem_assert(counters_new(), "index");
+    if(index == NULL || (termID = strpool_intern(index->terms, word)) < 0){
+        return false;
+    }
 
-    //add a counter for that word to the index;
-    return hashtable_insert(index->ht, word, counterset);
+    //create a counter set for the word, if it is new
+    mem_assert(index_counters(index, termID, &isNew), "index");
+    return isNew;
 }
 
 /**************** index_increment ****************/
 /* See index.h for usage documentation */
 int index_increment(index_t* index, const char* word, int docID){
-    counters_t* counterset;     //pointer to counterset in hashtable for gievn word
+    int termID;                 //term ID of the given word
+    counters_t* counterset;     //pointer to counterset in index for gievn word
     int count;                  //stores count of docID for a word in index
 
-    counterset =  hashtable_find(index->ht, word);
+    termID = strpool_find(index->terms, word);
+    counterset = termID < 0 ? NULL : index->postings[termID];
     //check if counterset exists
     mem_assert(counterset, "counterset to increment");
     count = counters_add(counterset, docID);
@@ -103,9 +156,46 @@ int index_increment(index_t* index, const char* word, int docID){
 /**************** index_find ****************/
 /* See index.h for usage documentation */
 void* index_find(index_t* index, const char* word){
-    counters_t* result; //stores result counterset
-    result = hashtable_find(index->ht, word);
-    return result;
+    int termID;         //term ID of the word, or -1 if it is not in the index
+
+    if(index == NULL || (termID = strpool_find(index->terms, word)) < 0){
+        return NULL;
+    }
+    return index->postings[termID];
+}
+
+/**************** index_upsert ****************/
+/* See index.h for usage documentation */
+int index_upsert(index_t* index, const char* word, const int length, const int docID){
+    unsigned long hash;         //full hash of the lowercase word
+    int termID;                 //term ID of the lowercase word
+    counters_t* counterset;     //counterset of the word
+    bool isNew;                 //whether the word was new to the index
+
+    if(index == NULL || word == NULL || length < 0){
+        return 0;
+    }
+    if(length + 1 > index->size){
+        //grow the buffer to at least double, so longer words rarely grow it again
+        int size = index->size * 2 > length + 1 ? index->size * 2 : length + 1;
+        //the word is copied in afresh, so the old buffer need not be
+        char* buffer = mem_malloc(size);
+        if(buffer == NULL){
+            return 0;
+        }
+        if(index->buffer != NULL){
+            mem_free(index->buffer);
+        }
+        index->buffer = buffer;
+        index->size = size;
+    }
+
+    hash = hash_jenkinsLower(word, length, index->buffer);
+    if((termID = strpool_internHashed(index->terms, index->buffer, hash)) < 0
+       || (counterset = index_counters(index, termID, &isNew)) == NULL){
+        return 0;
+    }
+    return counters_add(counterset, docID);
 }
 
 /**************** index_load ****************/
@@ -116,27 +206,55 @@ void index_load(index_t** index, FILE* fp){
     mem_assert(fp, "file");
 
     int slots;                  //number of slots in index
-    char* word;                 //word values for index
-    int docID;                  //docID values for index
-    int count;                  //count values for index
+    char* line;                 //one line of the index file
+    char* word;                 //word at the start of the line
+    char* rest;                 //rest of the line after the word, then after each number
+    char* end;                  //end of the number strtol just read
+    long docID;                 //docID values for index
+    long count;                 //count values for index
+    counters_t* counterset;     //counterset for the word on this line
+    bool isNew;                 //whether the word is new, not on an earlier line
 
     //initialize the inverted index to have the same number of slots as lines in the index file
     slots = file_numLines(fp);
     *index = mem_assert(index_new(slots), "inverted index\n");
 
-    //read word at the start of the line
-    while((word = file_readWord(fp)) != NULL){
-        //insert word into the index
-        index_insert(*index, word);
-        //advance along the line two numbers at a time until end
-        while(fscanf(fp,"%d %d ", &docID, &count) == 2){
-            while(count > 0){
-                //increment index for docID until it reaches count
-                index_increment(*index, word, docID);
-                count--;
+    //each line is a word followed by (docID, count) pairs
+    while((line = file_readLine(fp)) != NULL){
+        //split the word from the start of the line
+        for(word = line; isspace(*word); word++){
+        }
+        for(rest = word; *rest != '\0' && !isspace(*rest); rest++){
+        }
+        if(*rest != '\0'){
+            *rest++ = '\0';
+        }
+        if(*word == '\0'){
+            mem_free(line);
+            continue;
+        }
+
+        //find the word's counterset once for the whole line, or make it if the word is new
+        counterset = mem_assert(index_counters(*index, strpool_intern((*index)->terms, word), &isNew),
+                                "index");
+
+        //set each docID to its count in one step, two numbers at a time until end
+        while(true){
+            docID = strtol(rest, &end, 10);
+            if(end == rest){
+                break;
+            }
+            rest = end;
+            count = strtol(rest, &end, 10);
+            if(end == rest){
+                break;
+            }
+            rest = end;
+            if(count > 0){
+                counters_set(counterset, docID, count);
             }
         }
-        mem_free(word);
+        mem_free(line);
     }
 }
 
@@ -145,7 +263,9 @@ void index_load(index_t** index, FILE* fp){
 void index_iterate(index_t *index, void *arg, void (*itemfunc)(void *arg, const char *key, void *item)){
     mem_assert(index, "index");
     mem_assert(arg, "arg");
-    hashtable_iterate(index->ht, arg, itemfunc);
+    for(int termID = 0; termID < index->numTerms; termID++){
+        (*itemfunc)(arg, strpool_get(index->terms, termID), index->postings[termID]);
+    }
 }
 
 /**************** index_write ****************/
@@ -156,11 +276,38 @@ void index_write(index_t* index, FILE* fp){
     index_iterate(index, fp, index_printLines);
 }
 
+/**************** index_merge ****************/
+/* See index.h for usage documentation */
+void index_merge(index_t* dest, index_t* src){
+    counters_t* counterset;     //counterset for a word of src in dest
+    bool isNew;                 //whether the word was new to dest
+
+    mem_assert(dest, "index");
+    mem_assert(src, "index");
+    //add each word of src to dest if it is missing, then merge its counterset
+    for(int termID = 0; termID < src->numTerms; termID++){
+        counterset = mem_assert(index_counters(dest, strpool_intern(dest->terms, strpool_get(src->terms, termID)),
+                                               &isNew), "index");
+        if(!counters_merge(counterset, src->postings[termID])){
+            mem_assert(NULL, "index merge");
+        }
+    }
+}
+
 /**************** index_delete ****************/
 /* See index.h for usage documentation */
 void index_delete(index_t* index, void(*itemdelete)(void *item)){
     mem_assert(index, "index");
-    hashtable_delete(index->ht, itemdelete);
+    for(int termID = 0; termID < index->numTerms; termID++){
+        if(itemdelete != NULL){
+            (*itemdelete)(index->postings[termID]);
+        }
+    }
+    strpool_delete(index->terms);
+    mem_free(index->postings);
+    if(index->buffer != NULL){
+        mem_free(index->buffer);
+    }
     mem_free(index);
 }
 
@@ -1,25 +1,28 @@
 /* 
  * index.h
  *
- * An index is a hashtable of countersets. It is used by the Indexer module for TSE
+ * An index maps words to countersets. It is used by the Indexer module for TSE
  * 
- * The index stores a hashtable of of sets. 
- *      Each set key is a char* for a word.
- *      Each set points to a counterset
+ * The index interns each word in a strpool, which gives it a term ID. 
+ *      The words are packed together in the strpool's large blocks.
+ *      Each term ID is the position of its word's counterset in an array.
  *      Each counterset contains (docID, count) pairs.
+ * Finding a word is one probe of the strpool for its term ID, then one array lookup.
  * 
  * index contains methods to create, modify, load, write, and iterate indexes.
  *
  * Jack McMahon, February 14th, 2022
  */
 
+#ifndef __INDEX_H
+#define __INDEX_H
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include "../libcs50/mem.h"
 #include "../libcs50/counters.h"
-#include "../libcs50/hashtable.h"
+#include "../libcs50/strpool.h"
 #include "../libcs50/file.h"
 
 /**************** global types ****************/
@@ -31,7 +34,7 @@ typedef struct index index_t;  // opaque to users of the module
 /* Create a new (empty) index.
  *
  * Caller provides:
- *   number of slots to be used for the index (must be > 0).
+ *   number of words to make room for at first (must be > 0); the index grows as needed.
  * We return:
  *   pointer to the new index; return NULL if error.
  * We guarantee:
@@ -82,6 +85,22 @@ int index_increment(index_t* index, const char* word, int docID);
  */
 void* index_find(index_t* index, const char* word);
 
+/**************** index_upsert ****************/
+/* Count one more of a word in a docID, adding the word first if it is new
+ *
+ * Caller provides:
+ *   valid pointer to index, pointer to the first of length chars of the word,
+ *   which need not be null-terminated nor lowercase, and valid int for docID
+ * We return:
+ *   The count of docID for the lowercase word after incrementing, or 0 if error
+ * Notes:
+ *   The word is lowercased and hashed in one pass into a buffer the index keeps,
+ *   then looked up once; only a new word is copied, into the index.
+ *   Same as word_normalize, then index_find, index_insert if missing, and index_increment.
+ *   The buffer makes the index unsafe to upsert into from more than one thread at a time.
+ */
+int index_upsert(index_t* index, const char* word, const int length, const int docID);
+
 /**************** index_load ****************/
 /* Load an index from a file into a given index_t struct
  *
@@ -89,12 +108,15 @@ void* index_find(index_t* index, const char* word);
  *   valid double pointer to index, valid opened file.
  * We load the index from the file into the passed index pointer.
  * We return nothing.
- *
+ * Notes:
+ *   Each line must be a word followed by (docID, count) pairs, as index_write writes it;
+ *   each pair is set with its final count in one step, so a docID listed
+ *   twice for the same word keeps only its last count.
  */
 void index_load(index_t** index, FILE* fp);
 
 /**************** index_iterate ****************/
-/* iterate over the whole table;
+/* iterate over the whole index, in order of term ID, which is the order words were first added;
  * 
  * Caller provides:
  *   valid pointer to index, 
@@ -107,18 +129,33 @@ void index_load(index_t** index, FILE* fp);
 void index_iterate(index_t *index, void *arg, void (*itemfunc)(void *arg, const char *key, void *item));
 
 /**************** index_write ****************/
-/* write the whole table; provide the output file and func to print each item.
+/* write the whole index; provide the output file and func to print each item.
  * 
  * Caller provides:
  *   valid pointer to index, 
  *   FILE open for writing,
  * We print:
- * one line per index slot in FILE, start with word then listing (key,item) pairs in that slot.
+ * one line per word in FILE, in order of term ID, start with word then listing (docID, count) pairs.
  * Note:
  *   the index and its contents are not changed by this function,
  */
 void index_write(index_t* index, FILE* fp);
 
+/**************** index_merge ****************/
+/* Merge every word and (docID, count) pair of src into dest.
+ *
+ * Caller provides:
+ *   valid pointers to dest and src indexes.
+ * We do:
+ *   insert into dest each word of src that dest lacks, and add each count
+ *   of src to the count of the same word and docID in dest.
+ * Notes:
+ *   src is unchanged; the caller still deletes it.
+ *   Indexes built from disjoint sets of docIDs merge into exactly the
+ *   index that building them all into one would have produced.
+ */
+void index_merge(index_t* dest, index_t* src);
+
 /**************** index_delete ****************/
 /* Delete index, calling a delete function on each item.
  *
@@ -128,10 +165,11 @@ void index_write(index_t* index, FILE* fp);
  * We do:
  *   if index==NULL, throw error
  *   otherwise, unless itemfunc==NULL, call the itemfunc on each item.
- *   free all the key strings, and the index itself.
+ *   free all the words, and the index itself.
  * Notes:
- *   We free the strings that represent key for each item, because 
- *   this module allocated that memory in index_insert.
- *   We handle much of this by calling hashtable_delete.
+ *   We free the words, because this module copied them into its strpool.
+ *   We handle much of this by calling strpool_delete.
  */
-void index_delete(index_t* index, void (*itemdelete)(void* item));
\ No newline at end of file
+void index_delete(index_t* index, void (*itemdelete)(void* item));
+
+#endif // __INDEX_H
@@ -0,0 +1,357 @@
+/* 
+ * indexmap.c  
+ *
+ * An indexmap is an index in a binary file that is mapped into memory,
+ * or the same layout built in memory from an index_t by indexmap_freeze.
+ *
+ * see indexmap.h for more information.
+ */
+
+/* mmap and fileno are POSIX, not C11 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../libcs50/mem.h"
+#include "../libcs50/counters.h"
+#include "index.h"
+#include "indexmap.h"
+
+/**************** file types ****************/
+// the layout of the binary index file; see indexmap.h
+static const char MAGIC[8] = "TSEIDX1";
+
+typedef struct header {
+    char magic[8];              // MAGIC, including its null
+    uint32_t numWords;          // entries in the term dictionary
+    uint32_t numPostings;       // postings of all the words together
+    uint64_t poolSize;          // bytes of null-terminated words
+} header_t;
+
+typedef struct term {
+    uint32_t word;              // offset of the word in the pool
+    uint32_t postings;          // index of the word's first posting
+    uint32_t numPostings;       // number of postings for the word
+    uint32_t unused;            // keeps entries a multiple of 8 bytes
+} term_t;
+
+/**************** global types ****************/
+typedef struct indexmap {
+    void* base;                 // start of the mapped file, or of the frozen image
+    size_t size;                // length of the mapped file or image
+    bool mapped;                // whether base is mapped, rather than allocated
+    uint32_t numWords;          // entries in terms
+    const term_t* terms;        // the term dictionary, sorted by word
+    const posting_t* postings;  // the postings of all words
+    const char* pool;           // the words
+} indexmap_t;
+
+/**************** local types ****************/
+// a word of the index and its counterset, while writing
+typedef struct entry {
+    const char* word;
+    counters_t* counterset;
+} entry_t;
+
+// what the local iterate functions need while writing
+typedef struct builder {
+    entry_t* entries;           // one per word
+    posting_t* postings;        // postings of the current word
+    uint32_t numWords;          // words so far
+    uint32_t numPostings;       // postings so far
+    uint64_t poolSize;          // bytes of words so far
+} builder_t;
+
+/**************** local functions ****************/
+
+/**************** indexmap_countPosting ****************/
+/* 
+ * Passed to counters_iterate; counts the postings of a word.
+ */
+static void indexmap_countPosting(void *arg, const int key, const int count){
+    builder_t* builder = arg;
+    builder->numPostings++;
+}
+
+/**************** indexmap_addPosting ****************/
+/* 
+ * Passed to counters_iterate; appends a (docID, count) pair to the postings of the current word.
+ */
+static void indexmap_addPosting(void *arg, const int key, const int count){
+    builder_t* builder = arg;
+    builder->postings[builder->numPostings].docID = key;
+    builder->postings[builder->numPostings].count = count;
+    builder->numPostings++;
+}
+
+/**************** indexmap_addWord ****************/
+/* 
+ * Passed to index_iterate; records each word that has postings.
+ * With a NULL entries array, only counts the words and the bytes they need.
+ */
+static void indexmap_addWord(void *arg, const char *key, void *item){
+    builder_t* builder = arg;
+    uint32_t before = builder->numPostings;
+
+    counters_iterate(item, builder, indexmap_countPosting);
+    if(builder->numPostings == before){
+        return;
+    }
+    if(builder->entries != NULL){
+        builder->entries[builder->numWords].word = key;
+        builder->entries[builder->numWords].counterset = item;
+    }
+    builder->numWords++;
+    builder->poolSize += strlen(key) + 1;
+}
+
+/**************** compareEntries ****************/
+/* qsort order for entries: by word */
+static int compareEntries(const void* a, const void* b){
+    return strcmp(((const entry_t*)a)->word, ((const entry_t*)b)->word);
+}
+
+/**************** comparePostings ****************/
+/* qsort order for postings: by docID */
+static int comparePostings(const void* a, const void* b){
+    return ((const posting_t*)a)->docID - ((const posting_t*)b)->docID;
+}
+
+/**************** indexmap_build ****************/
+/* 
+ * Lays out the whole binary index file for index in one allocated image,
+ * and sets *size to its length. The caller must mem_free the image.
+ */
+static void* indexmap_build(index_t* index, size_t* size){
+    builder_t builder = {NULL, NULL, 0, 0, 0};
+    header_t* header;           //header at the start of the image
+    term_t* terms;              //term dictionary in the image
+    posting_t* postings;        //postings in the image
+    char* pool;                 //words in the image
+    void* image;
+
+    //count the words, then collect and sort them
+    index_iterate(index, &builder, indexmap_addWord);
+    *size = sizeof(header_t) + (size_t)builder.numWords * sizeof(term_t)
+            + (size_t)builder.numPostings * sizeof(posting_t) + builder.poolSize;
+    image = mem_calloc_assert(1, *size, "indexmap image");
+    header = image;
+    memcpy(header->magic, MAGIC, sizeof(MAGIC));
+    header->numWords = builder.numWords;
+    header->numPostings = builder.numPostings;
+    header->poolSize = builder.poolSize;
+    terms = (term_t*)(header + 1);
+    postings = (posting_t*)(terms + header->numWords);
+    pool = (char*)(postings + header->numPostings);
+
+    builder.entries = mem_malloc_assert((builder.numWords + 1) * sizeof(entry_t), "indexmap entries");
+    builder.numWords = builder.numPostings = 0;
+    builder.poolSize = 0;
+    index_iterate(index, &builder, indexmap_addWord);
+    qsort(builder.entries, builder.numWords, sizeof(entry_t), compareEntries);
+
+    //each word's dictionary entry, its postings sorted by docID, and the word itself
+    builder.postings = postings;
+    builder.numPostings = 0;
+    builder.poolSize = 0;
+    for(uint32_t i = 0; i < builder.numWords; i++){
+        size_t length = strlen(builder.entries[i].word) + 1;
+        terms[i].word = builder.poolSize;
+        terms[i].postings = builder.numPostings;
+        counters_iterate(builder.entries[i].counterset, &builder, indexmap_addPosting);
+        terms[i].numPostings = builder.numPostings - terms[i].postings;
+        qsort(postings + terms[i].postings, terms[i].numPostings, sizeof(posting_t), comparePostings);
+        memcpy(pool + builder.poolSize, builder.entries[i].word, length);
+        builder.poolSize += length;
+    }
+
+    mem_free(builder.entries);
+    return image;
+}
+
+/**************** indexmap_check ****************/
+/* 
+ * Returns: true if every term of the image points within it: its word starts in the pool,
+ * which ends with a null, and its postings lie within the postings of all the words;
+ * and if the words are in strictly ascending order, as are the docIDs of each word's
+ * postings, which the binary search of indexmap_termID and the intersection of
+ * postings in querier rely on.
+ * The header must already be known to add up to the image's size.
+ */
+static bool indexmap_check(const header_t* header){
+    const term_t* terms = (const term_t*)(header + 1);
+    const posting_t* postings = (const posting_t*)(terms + header->numWords);
+    const char* pool = (const char*)(postings + header->numPostings);
+
+    if(header->poolSize > 0 && pool[header->poolSize - 1] != '\0'){
+        return false;
+    }
+    for(uint32_t i = 0; i < header->numWords; i++){
+        if(terms[i].word >= header->poolSize
+           || (uint64_t)terms[i].postings + terms[i].numPostings > header->numPostings){
+            return false;
+        }
+        if(i > 0 && strcmp(pool + terms[i - 1].word, pool + terms[i].word) >= 0){
+            return false;
+        }
+        const posting_t* list = postings + terms[i].postings;  //this word's postings
+        for(uint32_t p = 1; p < terms[i].numPostings; p++){
+            if(list[p].docID <= list[p - 1].docID){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**************** indexmap_attach ****************/
+/* 
+ * Makes a new indexmap of the binary index file image at base, of the given size;
+ * NULL if it is not a binary index file, its parts do not add up to its size,
+ * any term points outside it, or its words or docIDs are out of order.
+ */
+static indexmap_t* indexmap_attach(void* base, const size_t size, const bool mapped){
+    const header_t* header = base;  //header at the start of the image
+
+    if(size < sizeof(header_t) || memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+       || sizeof(header_t) + (uint64_t)header->numWords * sizeof(term_t)
+          + (uint64_t)header->numPostings * sizeof(posting_t) + header->poolSize != size
+       || !indexmap_check(header)){
+        return NULL;
+    }
+
+    indexmap_t* map = mem_malloc_assert(sizeof(indexmap_t), "indexmap");
+    map->base = base;
+    map->size = size;
+    map->mapped = mapped;
+    map->numWords = header->numWords;
+    map->terms = (const term_t*)(header + 1);
+    map->postings = (const posting_t*)(map->terms + header->numWords);
+    map->pool = (const char*)(map->postings + header->numPostings);
+    return map;
+}
+
+/**************** functions ****************/
+
+/**************** indexmap_write ****************/
+/* See indexmap.h for usage documentation */
+bool indexmap_write(index_t* index, FILE* fp){
+    void* image;                //the whole file, laid out in memory
+    size_t size;                //bytes in image
+    bool ok;
+
+    if(index == NULL || fp == NULL){
+        return false;
+    }
+
+    image = indexmap_build(index, &size);
+    ok = fwrite(image, 1, size, fp) == size;
+    mem_free(image);
+    return ok;
+}
+
+/**************** indexmap_freeze ****************/
+/* See indexmap.h for usage documentation */
+indexmap_t* indexmap_freeze(index_t* index){
+    void* image;                //the frozen index, laid out as in the file
+    size_t size;                //bytes in image
+
+    if(index == NULL){
+        return NULL;
+    }
+    image = indexmap_build(index, &size);
+    return mem_assert(indexmap_attach(image, size, false), "frozen indexmap");
+}
+
+/**************** indexmap_open ****************/
+/* See indexmap.h for usage documentation */
+indexmap_t* indexmap_open(const char* filename){
+    int fd;                     //file descriptor of the index file
+    struct stat st;             //holds the size of the index file
+    void* base;                 //start of the mapping
+    indexmap_t* map;
+
+    if(filename == NULL || (fd = open(filename, O_RDONLY)) < 0){
+        return NULL;
+    }
+    if(fstat(fd, &st) != 0 || st.st_size < sizeof(header_t)){
+        close(fd);
+        return NULL;
+    }
+    base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(base == MAP_FAILED){
+        return NULL;
+    }
+
+    //check it is a binary index file, and that its parts add up to its size
+    if((map = indexmap_attach(base, st.st_size, true)) == NULL){
+        munmap(base, st.st_size);
+    }
+    return map;
+}
+
+/**************** indexmap_termID ****************/
+/* See indexmap.h for usage documentation */
+int indexmap_termID(indexmap_t* map, const char* word){
+    uint32_t low = 0;           //first entry that may hold word
+    uint32_t high;              //one past the last entry that may hold word
+
+    if(map == NULL || word == NULL){
+        return -1;
+    }
+
+    //binary search of the term dictionary
+    high = map->numWords;
+    while(low < high){
+        uint32_t mid = low + (high - low) / 2;
+        int cmp = strcmp(word, map->pool + map->terms[mid].word);
+        if(cmp == 0){
+            return mid;
+        }
+        else if(cmp < 0){
+            high = mid;
+        }
+        else{
+            low = mid + 1;
+        }
+    }
+    return -1;
+}
+
+/**************** indexmap_postings ****************/
+/* See indexmap.h for usage documentation */
+const posting_t* indexmap_postings(indexmap_t* map, const int termID, int* numPostings){
+    *numPostings = 0;
+    if(map == NULL || termID < 0 || (uint32_t)termID >= map->numWords){
+        return NULL;
+    }
+    *numPostings = map->terms[termID].numPostings;
+    return map->postings + map->terms[termID].postings;
+}
+
+/**************** indexmap_find ****************/
+/* See indexmap.h for usage documentation */
+const posting_t* indexmap_find(indexmap_t* map, const char* word, int* numPostings){
+    return indexmap_postings(map, indexmap_termID(map, word), numPostings);
+}
+
+/**************** indexmap_close ****************/
+/* See indexmap.h for usage documentation */
+void indexmap_close(indexmap_t* map){
+    if(map != NULL){
+        if(map->mapped){
+            munmap(map->base, map->size);
+        }
+        else{
+            mem_free(map->base);
+        }
+        mem_free(map);
+    }
+}
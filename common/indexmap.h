@@ -0,0 +1,135 @@
+/* 
+ * indexmap.h
+ *
+ * An indexmap is an index in a binary file that is mapped into memory rather than loaded.
+ * It is used by the Querier module for TSE, and written by the Indexer module.
+ * 
+ * The binary index file holds, in the machine's own byte order:
+ *      a header with a magic string and the number of words, postings, and bytes of words
+ *      a term dictionary, one entry per word, sorted by word
+ *      one array of postings per word, each a (docID, count) pair, sorted by docID
+ *      a pool of the null-terminated words the dictionary entries point into
+ * 
+ * Opening the file costs one mmap no matter how large the index is, and words are
+ * found by binary search of the dictionary straight from the mapping. Pages of the
+ * file are read in only as queries touch them, and are shared between processes.
+ * 
+ * An index_t that was loaded or built in memory can be frozen into an indexmap with the
+ * same layout. Nothing in an indexmap is ever written after it is opened or frozen,
+ * so any number of threads may find words in one at once, without locks.
+ */
+
+#ifndef __INDEXMAP_H
+#define __INDEXMAP_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "index.h"
+
+/**************** global types ****************/
+typedef struct indexmap indexmap_t;  // opaque to users of the module
+
+// one document a word appears in, and how many times it appears there
+typedef struct posting {
+    int docID;
+    int count;
+} posting_t;
+
+/**************** functions ****************/
+
+/**************** indexmap_write ****************/
+/* Write an index to a file in the binary index format.
+ *
+ * Caller provides:
+ *   valid pointer to index, FILE open for writing.
+ * We return:
+ *   true if the whole index was written, false if any parameter is NULL or error.
+ * Notes:
+ *   the index is unchanged by this operation.
+ *   words with no (docID, count) pairs are left out.
+ */
+bool indexmap_write(index_t* index, FILE* fp);
+
+/**************** indexmap_freeze ****************/
+/* Build an indexmap in memory holding the same words and postings as an index.
+ *
+ * Caller provides:
+ *   valid pointer to index.
+ * We return:
+ *   pointer to the new indexmap, laid out as a binary index file would be;
+ *   NULL if index is NULL.
+ * Caller is responsible for:
+ *   later calling indexmap_close.
+ * Notes:
+ *   the index is unchanged, and may be deleted once it is frozen;
+ *   the indexmap keeps nothing that points into it.
+ *   words with no (docID, count) pairs are left out.
+ */
+indexmap_t* indexmap_freeze(index_t* index);
+
+/**************** indexmap_open ****************/
+/* Map a binary index file into memory.
+ *
+ * Caller provides:
+ *   path of a file to open.
+ * We return:
+ *   pointer to the new indexmap;
+ *   NULL if the file cannot be opened, or is not a binary index file
+ *   (for example, an index file written by index_write), or is truncated or corrupt:
+ *   every term's word and postings are checked to lie within the file,
+ *   the words to be in strictly ascending order, and each word's docIDs too.
+ * Caller is responsible for:
+ *   later calling indexmap_close.
+ */
+indexmap_t* indexmap_open(const char* filename);
+
+/**************** indexmap_termID ****************/
+/* Return the term ID of the given word: its position in the term dictionary.
+ *
+ * Caller provides:
+ *   valid pointer to indexmap, valid string for word.
+ * We return:
+ *   the word's term ID, from 0; -1 if indexmap or word is NULL, or word is not found.
+ * Notes:
+ *   the term IDs of an indexmap are those of the words in sorted order,
+ *   not the term IDs of the index it was written from.
+ */
+int indexmap_termID(indexmap_t* map, const char* word);
+
+/**************** indexmap_postings ****************/
+/* Return the postings for the word with the given term ID.
+ *
+ * Caller provides:
+ *   valid pointer to indexmap, a term ID from indexmap_termID, valid pointer to an int.
+ * We return:
+ *   pointer to the word's postings, sorted by docID, and set *numPostings to their number;
+ *   NULL, with *numPostings 0, if indexmap is NULL or termID is -1.
+ * Notes:
+ *   as for indexmap_find; this is one array lookup, with no string comparisons.
+ */
+const posting_t* indexmap_postings(indexmap_t* map, const int termID, int* numPostings);
+
+/**************** indexmap_find ****************/
+/* Return the postings for the given word.
+ *
+ * Caller provides:
+ *   valid pointer to indexmap, valid string for word, valid pointer to an int.
+ * We return:
+ *   pointer to the word's postings, sorted by docID, and set *numPostings to their number;
+ *   NULL, with *numPostings 0, if indexmap or word is NULL, or word is not found.
+ * Notes:
+ *   the postings point into the mapped file; they are read-only,
+ *   and valid only until indexmap_close.
+ *   Same as indexmap_postings of indexmap_termID.
+ */
+const posting_t* indexmap_find(indexmap_t* map, const char* word, int* numPostings);
+
+/**************** indexmap_close ****************/
+/* Unmap the binary index file, or free the frozen index, and free the indexmap.
+ *
+ * Caller provides:
+ *   valid pointer to indexmap (may be NULL).
+ */
+void indexmap_close(indexmap_t* map);
+
+#endif // __INDEXMAP_H
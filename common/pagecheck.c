@@ -0,0 +1,126 @@
+/*
+ * pagecheck.c
+ *
+ * The driver shared by the testers of webpage's scans, wordtest and urltest.
+ *
+ * See pagecheck.h for usage documentation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../libcs50/mem.h"
+#include "../libcs50/webpage.h"
+#include "pagedir.h"
+#include "pagecheck.h"
+
+/**************** file-local global variables ****************/
+static const int NUMRANDOM = 20000;     // random html strings to check
+
+/**************** local types ****************/
+typedef struct totals {
+    int numPages;                       //pages and strings checked
+    int numFound;                       //things found that matched
+    int numBad;                         //pages and strings that did not
+} totals_t;
+
+/**************** local functions ****************/
+static void checkHTML(totals_t* totals, const char* html, const char* baseURL, const char* name,
+                      pagecheck_page_t checkPage);
+static void checkOne(totals_t* totals, webpage_t* page, const char* name, pagecheck_page_t checkPage);
+
+/**************** pagecheck_main ****************/
+/* See pagecheck.h for usage documentation */
+int pagecheck_main(const int argc, char* argv[], const char* what, const char* baseURL,
+                   const char* edges[], pagecheck_random_t randomHTML, pagecheck_page_t checkPage){
+
+    totals_t totals = {0, 0, 0};
+    char html[PAGECHECK_MAXRANDOM + 1];     //one random html string
+    char name[32];                          //name of it, for printing
+
+    for(int i = 0; edges[i] != NULL; i++){
+        sprintf(name, "edge case %d", i);
+        checkHTML(&totals, edges[i], baseURL, name, checkPage);
+    }
+
+    srand(1);
+    for(int i = 0; i < NUMRANDOM; i++){
+        randomHTML(html);
+        sprintf(name, "random html %d", i);
+        checkHTML(&totals, html, baseURL, name, checkPage);
+    }
+
+    //check every page of each pageDirectory, or the page fetched from each URL
+    for(int arg = 1; arg < argc; arg++){
+        webpage_t* page = NULL;
+        if(strncmp(argv[arg], "http://", 7) == 0){
+            char* url = mem_malloc_assert(strlen(argv[arg]) + 1, "url");
+            strcpy(url, argv[arg]);
+            page = mem_assert(webpage_new(url, 0, NULL), "webpage");
+            if(webpage_fetch(page)){
+                checkOne(&totals, page, argv[arg], checkPage);
+            }
+            else{
+                printf("%s: cannot fetch\n", argv[arg]);
+                totals.numPages++;
+                totals.numBad++;
+            }
+            webpage_delete(page);
+            continue;
+        }
+        for(int docID = 1; pagedir_load(&page, argv[arg], docID, NULL); docID++){
+            checkOne(&totals, page, webpage_getURL(page), checkPage);
+            webpage_delete(page);
+        }
+    }
+
+    printf("%d pages, %d %s matched; %d pages differed\n", totals.numPages, totals.numFound, what, totals.numBad);
+    return totals.numBad == 0 ? 0 : 1;
+}
+
+/**************** checkHTML ****************/
+/*
+* Input: totals to add to, html to check, URL of its page or NULL for its name, and its name
+* Checks a page at that URL holding a copy of the html
+*/
+static void checkHTML(totals_t* totals, const char* html, const char* baseURL, const char* name,
+                      pagecheck_page_t checkPage){
+    const char* base = baseURL != NULL ? baseURL : name;
+    char* copy = mem_malloc_assert(strlen(html) + 1, "html");
+    char* url = mem_malloc_assert(strlen(base) + 1, "url");
+    strcpy(copy, html);
+    strcpy(url, base);
+
+    webpage_t* page = mem_assert(webpage_new(url, 0, copy), "webpage");
+    checkOne(totals, page, name, checkPage);
+    webpage_delete(page);
+}
+
+/**************** checkOne ****************/
+/*
+* Input: totals to add to, webpage to check, its name for printing, and the tester's checkPage
+*
+* Runs checkPage on the page, then checks that it left the html alone and that
+* the page has the length of its html right, printing what differed.
+*/
+static void checkOne(totals_t* totals, webpage_t* page, const char* name, pagecheck_page_t checkPage){
+    const char* html = webpage_getHTML(page);
+    char* before = mem_malloc_assert(strlen(html) + 1, "html");
+    strcpy(before, html);
+
+    int found = checkPage(page, name);
+    if(found >= 0 && strcmp(before, html) != 0){
+        printf("%s: html changed\n", name);
+        found = -1;
+    }
+    if(found >= 0 && webpage_getHTMLLength(page) != strlen(html)){
+        printf("%s: html length is %zu; expected %zu\n", name, webpage_getHTMLLength(page), strlen(html));
+        found = -1;
+    }
+    mem_free(before);
+
+    totals->numPages++;
+    totals->numBad += found < 0;
+    totals->numFound += found > 0 ? found : 0;
+}
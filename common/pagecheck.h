@@ -0,0 +1,53 @@
+/*
+ * pagecheck.h
+ *
+ * pagecheck is the driver shared by the testers of webpage's scans, wordtest and urltest.
+ * Each tester compares what one scan finds on a page with what the original code found,
+ * in a checkPage function of its own; pagecheck runs that function on html the tester wrote
+ * for edge cases, on random html the tester builds, on every page of each pageDirectory
+ * given, and on the page fetched from each URL given, and reports the totals.
+ *
+ * On every page, pagecheck also checks that the scan left the html alone, and that the
+ * page has the length of its html right.
+ */
+
+#ifndef __PAGECHECK_H
+#define __PAGECHECK_H
+
+#include <stdio.h>
+#include "../libcs50/webpage.h"
+
+/**************** global types ****************/
+/* checkPage: compare the scan on page, whose name is for printing, printing the first
+ * difference; return how many things (words, links) were found, or -1 if the two differed.
+ */
+typedef int (*pagecheck_page_t)(webpage_t* page, const char* name);
+
+/* randomHTML: fill html with a random null-terminated string of at most
+ * PAGECHECK_MAXRANDOM chars, using rand().
+ */
+typedef void (*pagecheck_random_t)(char* html);
+
+/**************** global constants ****************/
+#define PAGECHECK_MAXRANDOM 1023     // longest random html string
+
+/**************** pagecheck_main ****************/
+/*
+ * Caller provides:
+ *      argc and argv of the tester, each argument a pageDirectory or an http:// URL
+ *      what the tester finds, plural, for printing, e.g. "words"
+ *      baseURL of the edge case and random pages, or NULL to use each one's name
+ *      edges, a NULL-terminated array of html for edge cases
+ *      randomHTML, to build each random html string, seeded the same every run
+ *      checkPage, to check each page
+ *
+ * We check each edge case, thousands of random html strings, then every page of each
+ * pageDirectory and the page fetched from each URL, printing
+ *      N pages, N <what> matched; N pages differed
+ *
+ * We return: the tester's exit status, 0 if no page differed, 1 otherwise
+ */
+int pagecheck_main(const int argc, char* argv[], const char* what, const char* baseURL,
+                   const char* edges[], pagecheck_random_t randomHTML, pagecheck_page_t checkPage);
+
+#endif // __PAGECHECK_H
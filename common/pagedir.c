@@ -19,7 +19,10 @@
 #include "../libcs50/mem.h"
 #include "../libcs50/webpage.h"
 #include "../libcs50/file.h"
+#include "../libcs50/arena.h"
 
+/**************** local functions ****************/
+static char* pagedir_path(const char* pageDirectory, const int docID, arena_t* scratch);
 
 /**************** pagedir_validate ****************/
 /* See pagedir.h for usage documentation */
@@ -84,7 +87,7 @@ bool pagedir_init(const char* pageDirectory)
 
 /**************** pagedir_save ****************/
 /* See pagedir.h for usage documentation */
-void pagedir_save(const webpage_t* page, const char* pageDirectory, const int docID)
+void pagedir_save(const webpage_t* page, const char* pageDirectory, const int docID, arena_t* scratch)
 {
     //check if webpage or directory are null
     if(page == NULL || pageDirectory == NULL){
@@ -93,19 +96,8 @@ void pagedir_save(const webpage_t* page, const char* pageDirectory, const int do
     }
     else{
         FILE* out;
-        //first make docID into a char*
-        int idLength = 10; 
-        char* pageName = mem_malloc(idLength*sizeof(char)); 
-        sprintf(pageName,"%d", docID);
-
-        //now create and malloc a char* for the pathname to the file
-        int length = strlen(pageDirectory) + idLength;
-        char* pathName = mem_malloc(length*sizeof(char)+1);
-
-        //copy the directory and id into the pathname
-        strcpy(pathName, pageDirectory);
-        strcat(pathName, "/");
-        strcat(pathName, pageName);
+        //create the pathname to the file
+        char* pathName = pagedir_path(pageDirectory, docID, scratch);
 
         //check if file is writeable
         if((out = fopen(pathName, "w")) == NULL) {
@@ -120,15 +112,16 @@ void pagedir_save(const webpage_t* page, const char* pageDirectory, const int do
         //print webpage URL, depth, and contents to file in directory
         fprintf(out, "%s\n%d\n%s", url, depth, html);
 
-        mem_free(pageName);
-        mem_free(pathName);
+        if(scratch == NULL){
+            mem_free(pathName);
+        }
         fclose(out);
     }
 }
 
 /**************** pagedir_load ****************/
 /* See pagedir.h for usage documentation */
-bool pagedir_load(webpage_t** page, const char* pageDirectory, const int docID)
+bool pagedir_load(webpage_t** page, const char* pageDirectory, const int docID, arena_t* scratch)
 {
     FILE* fp;           //file to open webpage file
     char* url;          //holds url from line 1 of webpage file
@@ -141,24 +134,15 @@ bool pagedir_load(webpage_t** page, const char* pageDirectory, const int docID)
     return false;
     }
     else{
-        //first make docID into a char*
-        int idLength = 10; 
-        char* pageID = mem_malloc(idLength*sizeof(char)); 
-        sprintf(pageID,"%d", docID);
-
-        //now create and malloc a char* for the pathname to the file
-        int length = strlen(pageDirectory) + idLength;
-        char* pathName = mem_malloc(length*sizeof(char)+1);
-
-        //copy the directory and id into the pathname
-        strcpy(pathName, pageDirectory);
-        strcat(pathName, "/");
-        strcat(pathName, pageID);
+        //create the pathname to the file
+        char* pathName = pagedir_path(pageDirectory, docID, scratch);
 
         //check if file is readable
-        if((fp = fopen(pathName, "r")) == NULL) {
-            mem_free(pageID);
+        fp = fopen(pathName, "r");
+        if(scratch == NULL){
             mem_free(pathName);
+        }
+        if(fp == NULL) {
             return false;
         }
         else{
@@ -170,11 +154,51 @@ bool pagedir_load(webpage_t** page, const char* pageDirectory, const int docID)
 
             //assign url, depth, and html to page passed from caller
             *page = mem_assert(webpage_new(url, depth, html), "webpage load new\n");
-            mem_free(pageID);
-            mem_free(pathName);
             mem_free(tempDepth);
             fclose(fp);
             return true;
         }
     }
-}
\ No newline at end of file
+}
+
+/**************** pagedir_count ****************/
+/* See pagedir.h for usage documentation */
+int pagedir_count(const char* pageDirectory)
+{
+    FILE* fp;           //file to check webpage file is readable
+    int docID = 0;      //last docID found
+
+    if(pageDirectory == NULL){
+        return 0;
+    }
+
+    //room for the directory, a slash, and any int docID
+    char* pathName = mem_malloc_assert(strlen(pageDirectory) + 13, "pathName");
+    while(true){
+        sprintf(pathName, "%s/%d", pageDirectory, docID + 1);
+        if((fp = fopen(pathName, "r")) == NULL){
+            break;
+        }
+        fclose(fp);
+        docID++;
+    }
+    mem_free(pathName);
+    return docID;
+}
+
+/**************** pagedir_path ****************/
+/* 
+ * Input: pageDirectory, docID, and arena_t* for scratch memory, or NULL
+ * Returns: the pathname of the docID's page file in pageDirectory, allocated from scratch,
+ *          or with mem_malloc for the caller to mem_free if scratch is NULL
+ */
+static char* pagedir_path(const char* pageDirectory, const int docID, arena_t* scratch)
+{
+    //room for the directory, a slash, and any int docID
+    size_t length = strlen(pageDirectory) + 13;
+    char* pathName = scratch != NULL ? arena_alloc(scratch, length) : mem_malloc(length);
+
+    mem_assert(pathName, "pathName");
+    sprintf(pathName, "%s/%d", pageDirectory, docID);
+    return pathName;
+}
@@ -17,6 +17,7 @@
 #include <math.h>
 #include "../libcs50/webpage.h"
 #include "../libcs50/file.h"
+#include "../libcs50/arena.h"
 
 /**************** pagedir_validate ****************/
 /* 
@@ -51,13 +52,15 @@ bool pagedir_init(const char* pageDirectory);
  *      webpage_t* for webpage infornation 
  *      char* for pageDirectory to save webpage information to as a file
  *      const int to label file with webpage information
+ *      arena_t* for scratch memory, or NULL to use mem_malloc
  * 
- * We construct the pathname for the page fil in pageDirectory
+ * We construct the pathname for the page fil in pageDirectory, in scratch if given
  * Open that file for writing and print webpage URL, depth and HTML then close the file
  * 
  * We return: nothing
+ * Caller is responsible for: resetting scratch, once done with the page
  */
-void pagedir_save(const webpage_t* page, const char* pageDirectory, const int docID);
+void pagedir_save(const webpage_t* page, const char* pageDirectory, const int docID, arena_t* scratch);
 
 /**************** pagedir_load ****************/
 /* 
@@ -65,11 +68,25 @@ void pagedir_save(const webpage_t* page, const char* pageDirectory, const int do
  *      webpage_t* that will be given loaded webpage inform ation
  *      char* for pageDirectory to load webpage file information from
  *      const int to identify the webpage file to be loaded from pageDIrectory
+ *      arena_t* for scratch memory, or NULL to use mem_malloc
  * 
- * We construct find the pathname to the sought after webpage file by scanning pageirectory and docID
+ * We construct find the pathname to the sought after webpage file by scanning pageirectory and docID,
+ * in scratch if given
  * We read the webpage file into the webpage_t data structure
  * We return: true if successful creation of webpage_t, false if otheriwse
+ * Caller is responsible for: resetting scratch, once done with the page
  */
-bool pagedir_load(webpage_t** page, const char* pageDirectory, const int docID);
+bool pagedir_load(webpage_t** page, const char* pageDirectory, const int docID, arena_t* scratch);
+
+/**************** pagedir_count ****************/
+/* 
+ * Caller provides:
+ *      char* for pageDirectory to count webpage files in
+ * 
+ * We count webpage files 1, 2, 3... in pageDirectory until one cannot be opened for reading,
+ * so these are exactly the docIDs that loading them one after another with pagedir_load would reach.
+ * We return: the number of webpage files counted, 0 if pageDirectory is NULL
+ */
+int pagedir_count(const char* pageDirectory);
 
 #endif // __PAGEDIR_H
@@ -0,0 +1,177 @@
+/* 
+ * urltable.c  
+ *
+ * A urltable maps each docID in a pageDirectory to the URL of its page.
+ *
+ * see urltable.h for more information.
+ */
+
+/* mmap is POSIX, not C11 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../libcs50/mem.h"
+#include "urltable.h"
+
+/**************** file types ****************/
+// the layout of the .urls file; see urltable.h
+static const char MAGIC[8] = "TSEURL1";
+static const char* FILENAME = "/.urls";
+
+typedef struct header {
+    char magic[8];              // MAGIC, including its null
+    uint32_t numDocs;           // entries in the offset array
+    uint32_t poolSize;          // bytes of null-terminated URLs
+} header_t;
+
+/**************** global types ****************/
+typedef struct urltable {
+    void* base;                 // start of the mapped file
+    size_t size;                // length of the mapped file
+    int numDocs;                // entries in offsets
+    const uint32_t* offsets;    // offset in pool of the URL of each docID, from 1
+    const char* pool;           // the URLs
+} urltable_t;
+
+/**************** local functions ****************/
+
+/**************** urltable_path ****************/
+/* Return the path of the .urls file in pageDirectory, which the caller must free. */
+static char* urltable_path(const char* pageDirectory){
+    char* pathName = mem_malloc_assert(strlen(pageDirectory) + strlen(FILENAME) + 1, "pathName");
+    strcpy(pathName, pageDirectory);
+    strcat(pathName, FILENAME);
+    return pathName;
+}
+
+/**************** urltable_check ****************/
+/* 
+ * Returns: true if the URL of every docID starts in the pool, which ends with a null.
+ * The header must already be known to add up to the file's size.
+ */
+static bool urltable_check(const header_t* header){
+    const uint32_t* offsets = (const uint32_t*)(header + 1);
+    const char* pool = (const char*)(offsets + header->numDocs);
+
+    if(header->poolSize > 0 && pool[header->poolSize - 1] != '\0'){
+        return false;
+    }
+    for(uint32_t i = 0; i < header->numDocs; i++){
+        if(offsets[i] >= header->poolSize){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**************** functions ****************/
+
+/**************** urltable_write ****************/
+/* See urltable.h for usage documentation */
+bool urltable_write(const char* pageDirectory, char** urls, const int numDocs){
+    header_t header;            //header of the file
+    uint32_t offset = 0;        //offset of the next URL in the pool
+    FILE* fp;                   //the .urls file
+    bool ok;                    //whether everything was written so far
+
+    if(pageDirectory == NULL || (urls == NULL && numDocs > 0) || numDocs < 0){
+        return false;
+    }
+
+    char* pathName = urltable_path(pageDirectory);
+    fp = fopen(pathName, "w");
+    mem_free(pathName);
+    if(fp == NULL){
+        return false;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.numDocs = numDocs;
+    for(int i = 0; i < numDocs; i++){
+        header.poolSize += (urls[i] == NULL ? 0 : strlen(urls[i])) + 1;
+    }
+    ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+    //the offsets, then the URLs they point to
+    for(int i = 0; ok && i < numDocs; i++){
+        ok = fwrite(&offset, sizeof(offset), 1, fp) == 1;
+        offset += (urls[i] == NULL ? 0 : strlen(urls[i])) + 1;
+    }
+    for(int i = 0; ok && i < numDocs; i++){
+        ok = (urls[i] == NULL || fputs(urls[i], fp) != EOF) && fputc('\0', fp) != EOF;
+    }
+
+    return fclose(fp) == 0 && ok;
+}
+
+/**************** urltable_open ****************/
+/* See urltable.h for usage documentation */
+urltable_t* urltable_open(const char* pageDirectory){
+    int fd;                     //file descriptor of the .urls file
+    struct stat st;             //holds the size of the .urls file
+    void* base;                 //start of the mapping
+    const header_t* header;     //header at the start of the mapping
+
+    if(pageDirectory == NULL){
+        return NULL;
+    }
+    char* pathName = urltable_path(pageDirectory);
+    fd = open(pathName, O_RDONLY);
+    mem_free(pathName);
+    if(fd < 0){
+        return NULL;
+    }
+    if(fstat(fd, &st) != 0 || st.st_size < sizeof(header_t)){
+        close(fd);
+        return NULL;
+    }
+    base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(base == MAP_FAILED){
+        return NULL;
+    }
+
+    //check it is a URL table, that its parts add up to its size, and that each URL lies within it
+    header = base;
+    if(memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+       || sizeof(header_t) + (uint64_t)header->numDocs * sizeof(uint32_t) + header->poolSize != st.st_size
+       || !urltable_check(header)){
+        munmap(base, st.st_size);
+        return NULL;
+    }
+
+    urltable_t* table = mem_malloc_assert(sizeof(urltable_t), "urltable");
+    table->base = base;
+    table->size = st.st_size;
+    table->numDocs = header->numDocs;
+    table->offsets = (const uint32_t*)(header + 1);
+    table->pool = (const char*)(table->offsets + header->numDocs);
+    return table;
+}
+
+/**************** urltable_find ****************/
+/* See urltable.h for usage documentation */
+const char* urltable_find(urltable_t* table, const int docID){
+    if(table == NULL || docID < 1 || docID > table->numDocs){
+        return NULL;
+    }
+    const char* url = table->pool + table->offsets[docID - 1];
+    return *url == '\0' ? NULL : url;
+}
+
+/**************** urltable_close ****************/
+/* See urltable.h for usage documentation */
+void urltable_close(urltable_t* table){
+    if(table != NULL){
+        munmap(table->base, table->size);
+        mem_free(table);
+    }
+}
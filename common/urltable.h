@@ -0,0 +1,73 @@
+/* 
+ * urltable.h
+ *
+ * A urltable maps each docID in a pageDirectory to the URL of its page, so the URL
+ * can be found without opening the page file.
+ * It is written by the Crawler and Indexer modules for TSE, and used by the Querier.
+ * 
+ * The table is the file .urls in the pageDirectory, holding, in the machine's own byte order:
+ *      a header with a magic string and the number of docIDs
+ *      an array of offsets, one per docID from 1, of each URL in the pool
+ *      a pool of the null-terminated URLs
+ * 
+ * Opening the table maps the file into memory, so finding a URL is one array lookup.
+ */
+
+#ifndef __URLTABLE_H
+#define __URLTABLE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**************** global types ****************/
+typedef struct urltable urltable_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** urltable_write ****************/
+/* Write the URL table of a pageDirectory.
+ *
+ * Caller provides:
+ *   char* for pageDirectory, array of the URLs of docIDs 1 to numDocs
+ *   (urls[0] is the URL of docID 1), and numDocs.
+ * We return:
+ *   true if pageDirectory/.urls was written, false if any parameter is NULL or error.
+ * Notes:
+ *   a NULL URL in the array is written as an empty string.
+ */
+bool urltable_write(const char* pageDirectory, char** urls, const int numDocs);
+
+/**************** urltable_open ****************/
+/* Map the URL table of a pageDirectory into memory.
+ *
+ * Caller provides:
+ *   char* for pageDirectory.
+ * We return:
+ *   pointer to the new urltable;
+ *   NULL if pageDirectory has no .urls file or it is not a URL table,
+ *   or is truncated or corrupt: every URL is checked to lie within the file.
+ * Caller is responsible for:
+ *   later calling urltable_close.
+ */
+urltable_t* urltable_open(const char* pageDirectory);
+
+/**************** urltable_find ****************/
+/* Return the URL of the page with the given docID.
+ *
+ * Caller provides:
+ *   valid pointer to urltable, docID.
+ * We return:
+ *   the URL, which points into the mapped file and is valid until urltable_close;
+ *   NULL if table is NULL, or docID is not in the table or has no URL.
+ */
+const char* urltable_find(urltable_t* table, const int docID);
+
+/**************** urltable_close ****************/
+/* Unmap the URL table and free the urltable.
+ *
+ * Caller provides:
+ *   valid pointer to urltable (may be NULL).
+ */
+void urltable_close(urltable_t* table);
+
+#endif // __URLTABLE_H
@@ -15,8 +15,8 @@
 /* See word.h for usage documentation */
 void word_normalize(char* word){
 
-    for(int i = 0; i < strlen(word); i++){
+    for(int i = 0; word[i] != '\0'; i++){
         char temp = tolower(word[i]);
         word[i] = temp;
     }
-}
\ No newline at end of file
+}
@@ -20,4 +20,4 @@
  * We return: 
  *     nothing
  */
-void word_normalize(char* word);
\ No newline at end of file
+void word_normalize(char* word);
@@ -5,6 +5,8 @@
  * Written with consultation of CS50 knowledge pages and using methods from libcs50
  * 
  * Crawler takes three arguements, a seed URL, page Directory, and depth
+ *
+ *      crawler [-j numThreads] [-d delay] seedURL pageDirectory maxDepth
  * 
  * It will crawl from the seed URL to linked URLS going as for as the depth argument specifies.
  * It will then save the contents of each crawled webpage to a file in the page Directory.
@@ -14,8 +16,19 @@
  * depth must be between 0 and 10(inclusive).
  * The page directory must be writeable and also must not contain
  * any files whose name is an integer
+ * numThreads, if given, must be between 1 and MAXTHREADS(inclusive); it defaults to 1.
+ * delay, if given, must be at least 0; it defaults to 1000.
  * 
- * Crawler also pauses for one second between page fetches to avoid overloading the webservser
+ * Crawler also pauses for delay milliseconds between page fetches from the same host to avoid
+ * overloading the webservser; fetches from different hosts do not wait for each other.
+ *
+ * With -j, crawler runs numThreads worker threads that each take a page from the bag,
+ * fetch it, and then save and scan it, so up to numThreads fetches are in flight at once.
+ * The bag, the hashtable of pages seen, and the docID counter are shared by the workers
+ * and only touched while holding the crawl lock; only the fetch itself runs unlocked.
+ *
+ * Once the crawl is done, crawler writes the URL of every page it saved to pageDirectory/.urls
+ * (see urltable.h), so querier can find them without opening each page file.
  * 
  * Jack McMahon, February 5th 2022
  */
@@ -23,16 +36,42 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
 #include "../libcs50/mem.h"
 #include "../libcs50/webpage.h"
 #include "../libcs50/bag.h"
 #include "../libcs50/hashtable.h"
+#include "../libcs50/arena.h"
 #include "../common/pagedir.h"
+#include "../common/urltable.h"
+
 
+/**************** global types ****************/
+// state shared by all crawl workers; everything but the constants is guarded by lock
+typedef struct crawlstate {
+    bag_t* pagesToCrawl;        // bag that holds pages to crawl
+    hashtable_t* pagesSeen;     // hashtable that holds pages seen
+    char* pageDirectory;        // directory to save pages to
+    int maxDepth;               // maximum depth to crawl
+    int docID;                  // next docID to assign
+    int inFlight;               // pages taken from the bag but not yet scanned
+    char** urls;                // URL of each docID saved, from 1
+    int urlsSize;               // URLs urls has room for
+    pthread_mutex_t lock;       // guards the fields above
+    pthread_cond_t changed;     // signalled when pages are added or inFlight drops
+} crawlstate_t;
+
+static const int MAXTHREADS = 64;   // maximum number of crawl workers
+static const size_t SCRATCHSIZE = 4096;     // bytes in each block of a worker's scratch arena
 
 // function prototypes
-static void parseArgs(const int argc, char* argv[], char** seedURL, char** pageDirectory, int* maxDepth);
-static void crawl(char* seedURL, char* pageDirectory, const int maxDepth);
+static void parseArgs(const int argc, char* argv[], char** seedURL, char** pageDirectory, int* maxDepth,
+                      int* numThreads, int* delay);
+static void crawl(char* seedURL, char* pageDirectory, const int maxDepth, const int numThreads);
+static void* crawlWorker(void* arg);
+static webpage_t* nextPage(crawlstate_t* state);
+static void saveURL(crawlstate_t* state, const char* url);
 static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSeen);
 
 /* ********************* main ************************ */
@@ -42,14 +81,18 @@ int main(const int argc, char* argv[]){
     char* seedURL; //URL of the seed webpage
     char* pageDirectory; //Directory that we will writefiles to for each crawled webpage
     int maxDepth = 0; //integer for the maximum depth our program will search 
+    int numThreads = 1; //number of pages to fetch at once
+    int delay = 1000; //milliseconds between fetches from one host
 
     //parse arguments to check if they match correct input type, if so assign to variables
-    parseArgs(argc, argv, &seedURL, &pageDirectory, &maxDepth);
+    parseArgs(argc, argv, &seedURL, &pageDirectory, &maxDepth, &numThreads, &delay);
 
     //crawl pages and add them to pageDirectory
-    crawl(seedURL, pageDirectory, maxDepth);
+    webpage_setPoliteness(delay);
+    crawl(seedURL, pageDirectory, maxDepth, numThreads);
     
     //free memory at the end
+    webpage_cleanup();
     mem_free(pageDirectory);
 
     exit(0);
@@ -57,22 +100,51 @@ int main(const int argc, char* argv[]){
 
 /**************** parseArgs ****************/
 /* 
-* Input: char* for seed URL, char* for page directory, int for max depth
+* Input: char* for seed URL, char* for page directory, int for max depth, int for number of threads,
+*        int for politeness delay
  * 
  * Makes sure arguments match the given specifications, if so then assigns them to variables
+ * The optional -j numThreads and -d delay come before the three required arguments.
 */
 static void parseArgs(const int argc, char* argv[],
-                      char** seedURL, char** pageDirectory, int* maxDepth) {
-    if(argc != 4){
+                      char** seedURL, char** pageDirectory, int* maxDepth,
+                      int* numThreads, int* delay) {
+    int arg = 1; //index of the first required argument
+
+    //check for the optional -j numThreads and -d delay
+    while(arg < argc && argv[arg][0] == '-'){
+        if(strcmp(argv[arg], "-j") == 0){
+            if(arg + 1 >= argc || (*numThreads = atoi(argv[arg + 1])) < 1 || *numThreads > MAXTHREADS){
+                //throw error if thread count is missing or out of bounds
+                fprintf(stderr, "Number of threads must be between 1 and %d.\n", MAXTHREADS);
+                exit(7);
+            }
+        }
+        else if(strcmp(argv[arg], "-d") == 0){
+            if(arg + 1 >= argc || (*delay = atoi(argv[arg + 1])) < 0){
+                //throw error if delay is missing or negative
+                fprintf(stderr, "Delay must be at least 0 milliseconds.\n");
+                exit(8);
+            }
+        }
+        else{
+            //throw error if unknown option
+            fprintf(stderr, "Unknown option %s.\n", argv[arg]);
+            exit(1);
+        }
+        arg += 2;
+    }
+
+    if(argc - arg != 3){
         //throw error if incorrect number of arguments
         fprintf(stderr, "Incorrect number of arguments.\n");
         exit(1);
     }
 
     char* normalizedURL; // stores normalized URL
-    *seedURL = mem_malloc(strlen(argv[1]) + 1);
+    *seedURL = mem_malloc(strlen(argv[arg]) + 1);
     //check if URL can be normalized
-    if((normalizedURL = normalizeURL(argv[1])) == NULL){
+    if((normalizedURL = normalizeURL(argv[arg])) == NULL){
         fprintf(stderr, "Failed to normalize URL\n");
         exit(17);
     }
@@ -86,8 +158,8 @@ static void parseArgs(const int argc, char* argv[],
         exit(2);
     }
 
-    *pageDirectory = mem_malloc_assert((strlen(argv[2]) + 1), "pageDirectory");
-    strcpy(*pageDirectory, argv[2]);
+    *pageDirectory = mem_malloc_assert((strlen(argv[arg + 1]) + 1), "pageDirectory");
+    strcpy(*pageDirectory, argv[arg + 1]);
     
     if ( ! pagedir_init(*pageDirectory)) {
         //throw error if can't write in  given page directory
@@ -95,7 +167,7 @@ static void parseArgs(const int argc, char* argv[],
         exit(3);
     }
 
-    int n = atoi(argv[3]);
+    int n = atoi(argv[arg + 2]);
     if (n > 10 || n < 0){
         //throw error max depth is out of bounds
         fprintf(stderr, "Max Depth is out of range.\n");
@@ -110,54 +182,166 @@ static void parseArgs(const int argc, char* argv[],
 
 /**************** Crawl ****************/
 /* 
-* Input: char* for seed URL, char* for page directory, int for max depth
+* Input: char* for seed URL, char* for page directory, int for max depth, int for number of threads
 * 
-* Finds linked URLs for a given webpage and adds them to the bag and tashatble if not at max depth
+* Sets up the bag of pages to crawl and the hashtable of pages seen, starting from the seed URL,
+* then runs numThreads crawlWorkers over them until every reachable page has been crawled.
 */
-static void crawl(char* seedURL, char* pageDirectory, const int maxDepth)
+static void crawl(char* seedURL, char* pageDirectory, const int maxDepth, const int numThreads)
 {
-    hashtable_t* pagesSeen; //hashtable that holds pages seen
-    bag_t* pagesToCrawl;    //bag that holds pages to crawl
-    webpage_t* current;     //webpage_t to hold the current webpage
+    crawlstate_t state;     //state shared by the workers
     const int SLOTS = 200;  // num slots for hashtable
-    int i = 1;              //counter for  docIDs
+    webpage_t* seed;        //webpage_t for the seed URL
+    pthread_t* workers;     //worker threads
     
     //create hashtable of pages seen and add the seed URL
-    pagesSeen = mem_assert(hashtable_new(SLOTS), "pagesSeen new\n");
+    state.pagesSeen = mem_assert(hashtable_new(SLOTS), "pagesSeen new\n");
     
-    if ( ! (hashtable_insert(pagesSeen, seedURL, ""))) {
+    if ( ! (hashtable_insert(state.pagesSeen, seedURL, ""))) {
         fprintf(stderr, "error\n");
         exit(12);
     }
     
     //create a bag of unexplored pages and add a webpage structure for the seednode
-    pagesToCrawl = mem_assert(bag_new(), "bag new\n");
-    current = mem_assert(webpage_new(seedURL, 0, NULL), "webpage new\n");
-    bag_insert(pagesToCrawl, current);
-    
-    //loop through all pages reachable from the seed up to the max depth
-    //fetch HTML and save each page to the directory if successful
-    while((current = bag_extract(pagesToCrawl)) != NULL) {
-        if (webpage_fetch(current)) {
+    state.pagesToCrawl = mem_assert(bag_new(), "bag new\n");
+    seed = mem_assert(webpage_new(seedURL, 0, NULL), "webpage new\n");
+    bag_insert(state.pagesToCrawl, seed);
+
+    state.pageDirectory = pageDirectory;
+    state.maxDepth = maxDepth;
+    state.docID = 1;
+    state.inFlight = 0;
+    state.urls = NULL;
+    state.urlsSize = 0;
+    pthread_mutex_init(&state.lock, NULL);
+    pthread_cond_init(&state.changed, NULL);
+
+    //crawl with numThreads workers; with one worker this is the plain sequential crawl
+    workers = mem_malloc_assert(numThreads * sizeof(pthread_t), "workers");
+    for (int t = 0; t < numThreads; t++) {
+        if (pthread_create(&workers[t], NULL, crawlWorker, &state) != 0) {
+            fprintf(stderr, "Cannot create crawl thread\n");
+            exit(13);
+        }
+    }
+    for (int t = 0; t < numThreads; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    mem_free(workers);
+
+    //free data structures
+    pthread_cond_destroy(&state.changed);
+    pthread_mutex_destroy(&state.lock);
+    //record the URL of each page saved for querier
+    if (!urltable_write(pageDirectory, state.urls, state.docID - 1)) {
+        fprintf(stderr, "Cannot write URL table to %s\n", pageDirectory);
+    }
+    for (int i = 0; i < state.docID - 1; i++) {
+        mem_free(state.urls[i]);
+    }
+    mem_free(state.urls);
+
+    hashtable_delete(state.pagesSeen, NULL);
+    bag_delete(state.pagesToCrawl, webpage_delete);
+}
+
+/**************** crawlWorker ****************/
+/* 
+* Input: crawlstate_t* shared by all workers, as a void* for pthread_create
+* 
+* Loops through pages reachable from the seed up to the max depth,
+* fetching the HTML and saving each page to the directory if successful.
+* The fetch runs without the lock so other workers can fetch at the same time;
+* assigning the docID, saving, and scanning for links happen under the lock.
+* Memory needed only while saving one page comes from an arena of the worker's own,
+* reset after each page.
+*
+* Returns: NULL once the bag is empty and no other worker can add to it
+*/
+static void* crawlWorker(void* arg)
+{
+    crawlstate_t* state = arg;  //state shared by the workers
+    webpage_t* current;         //webpage_t to hold the current webpage
+    bool fetched;               //whether the current page was fetched
+    arena_t* scratch = mem_assert(arena_new(SCRATCHSIZE), "scratch arena");  //memory for the current page only
+
+    while((current = nextPage(state)) != NULL) {
+        fetched = webpage_fetch(current);
+
+        pthread_mutex_lock(&state->lock);
+        if (fetched) {
             #ifdef VERBOSE
               printf("%d, Fetched, %s\n", webpage_getDepth(current), webpage_getURL(current));
             #endif
-            pagedir_save(current, pageDirectory, i);
-            i++;
+            pagedir_save(current, state->pageDirectory, state->docID, scratch);
+            saveURL(state, webpage_getURL(current));
+            state->docID++;
             //if webpage is not at max depth scan for connected pages
-            if  (webpage_getDepth(current) < maxDepth) {
+            if  (webpage_getDepth(current) < state->maxDepth) {
                 #ifdef VERBOSE
                      printf("%d, Scanning, %s\n", webpage_getDepth(current), webpage_getURL(current));
                 #endif
-                pageScan(current, pagesToCrawl, pagesSeen);
+                pageScan(current, state->pagesToCrawl, state->pagesSeen);
             }
         }
+        //this page is done; wake any worker waiting for more pages or for the end
+        state->inFlight--;
+        pthread_cond_broadcast(&state->changed);
+        pthread_mutex_unlock(&state->lock);
+
         //free webpage from the bag
         webpage_delete(current);
+        arena_reset(scratch);
     }
-    //free data structures
-    hashtable_delete(pagesSeen, NULL);
-    bag_delete(pagesToCrawl, webpage_delete);
+    arena_delete(scratch);
+    return NULL;
+}
+
+/**************** nextPage ****************/
+/* 
+* Input: crawlstate_t* shared by all workers
+* 
+* Takes the next page to crawl from the bag. If the bag is empty but other workers
+* still have pages in flight, waits for them, since their pages may add more.
+*
+* Returns: the next webpage_t to crawl, or NULL when the crawl is finished
+*/
+static webpage_t* nextPage(crawlstate_t* state)
+{
+    webpage_t* page;    //page taken from the bag
+
+    pthread_mutex_lock(&state->lock);
+    while((page = bag_extract(state->pagesToCrawl)) == NULL && state->inFlight > 0) {
+        pthread_cond_wait(&state->changed, &state->lock);
+    }
+    if (page != NULL) {
+        state->inFlight++;
+    }
+    pthread_mutex_unlock(&state->lock);
+
+    return page;
+}
+
+/**************** saveURL ****************/
+/* 
+* Input: crawlstate_t* shared by all workers, URL of the page just saved as state->docID
+* 
+* Records a copy of the URL for docID in the state's table of URLs, doubling its room as needed.
+* Caller must hold the crawl lock.
+*/
+static void saveURL(crawlstate_t* state, const char* url)
+{
+    if (state->docID > state->urlsSize) {
+        state->urlsSize = state->urlsSize == 0 ? 64 : state->urlsSize * 2;
+        char** urls = mem_malloc_assert(state->urlsSize * sizeof(char*), "urls");
+        if (state->urls != NULL) {
+            memcpy(urls, state->urls, (state->docID - 1) * sizeof(char*));
+            mem_free(state->urls);
+        }
+        state->urls = urls;
+    }
+    state->urls[state->docID - 1] = mem_malloc_assert(strlen(url) + 1, "url");
+    strcpy(state->urls[state->docID - 1], url);
 }
 
 /**************** pageScan ****************/
@@ -165,6 +349,8 @@ static void crawl(char* seedURL, char* pageDirectory, const int maxDepth)
  * Input: webpage_t to scan, bag_t of pages tp crawl, hashtable_t of pages seen
  * 
  * Finds linked URLs for a given webpage and adds them to the bag and tashatble if not at max depth
+ * Each URL is malloc'd by webpage_getNextURL and normalizeURL, not taken from scratch. A new one is
+ * adopted by its webpage_t; hashtable_insert copies it for the key, so the others are freed here.
 */
 static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSeen)
 {
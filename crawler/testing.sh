@@ -11,6 +11,12 @@ myvalgrind='valgrind --leak-check=full --show-leak-kinds=all'
 # Test with incorrect number of arguments
 ./crawler
 
+# Test with bad thread count
+./crawler -j 0 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html ../data/letters3 2
+
+# Test with bad politeness delay
+./crawler -d -5 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html ../data/letters3 2
+
 # Test with bad URL
 mkdir ../data/test2
 ./crawler https://www.nytimes.com ../data/test2 2
@@ -38,6 +44,17 @@ mkdir ../data/letters1
 mkdir ../data/letters10
 ./crawler http://cs50tse.cs.dartmouth.edu/tse/letters/index.html ../data/letters10 10
 
+# Test with letters on depth 10 with 4 fetches in flight; should find the same pages as letters10
+mkdir ../data/letters10-j4
+./crawler -j 4 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html ../data/letters10-j4 10
+ls ../data/letters10 | wc -l
+ls ../data/letters10-j4 | wc -l
+
+# Test with letters on depth 10, half a second between fetches
+mkdir ../data/letters10-d500
+./crawler -d 500 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html ../data/letters10-d500 10
+ls ../data/letters10-d500 | wc -l
+
 # Test with wikipedia on depth 0
 mkdir ../data/wikipedia0
 ./crawler http://cs50tse.cs.dartmouth.edu/tse/wikipedia/index.html ../data/wikipedia0 0
@@ -45,3 +62,8 @@ mkdir ../data/wikipedia0
 # Test with wikipedia on depth 1
 mkdir ../data/wikipedia1
 ./crawler http://cs50tse.cs.dartmouth.edu/tse/wikipedia/index.html ../data/wikipedia1 1
+
+# Test the link extractor against the original one on the pages just crawled,
+# and on pages fetched now
+./urltest ../data/toscrape1 ../data/letters10 ../data/wikipedia1 \
+    http://cs50tse.cs.dartmouth.edu/tse/letters/index.html http://cs50tse.cs.dartmouth.edu/tse/wikipedia/index.html
@@ -0,0 +1,261 @@
+/*
+ * urltest.c
+ *
+ * This is a tester for webpage_getNextURL, which finds links without first removing
+ * the white space from a page's html, and scans it many bytes at a time.
+ * It takes any number of arguments, each a pageDirectory or the URL of a page to fetch:
+ *          char*  pageDirectory or URL...
+ *
+ * Urltest checks that webpage_getNextURL finds exactly the links, in the same order, that
+ * the original extractor did: that extractor is copied below as nextURL, and run on a copy
+ * of the html with its white space removed, as it used to remove it. The pages are checked
+ * by pagecheck, as wordtest's are: html written to catch white space inside tags and links,
+ * and malformed links; thousands of random html strings built from pieces of links; then
+ * every page of each pageDirectory given, and each page fetched from a URL given.
+ *
+ * Prints how many pages and links matched, and exits 0 if all did; otherwise prints
+ * the first difference in each page that differed, and exits 1.
+ */
+
+#define _GNU_SOURCE       // strcasestr, as webpage.c uses
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include "../libcs50/mem.h"
+#include "../libcs50/webpage.h"
+#include "../common/pagecheck.h"
+
+/**************** file-local global variables ****************/
+static const char* BASEURL = "http://cs50tse.cs.dartmouth.edu/tse/site/dir/index.html";
+static const int MAXPIECES = 24;        // most pieces in a random html string
+static const char* PIECES[] = {         // pieces the random strings are built from
+    "<a", "<A", "< a", "<\na", "<b>", "<abbr>", " href=", "HREF=", "h ref =", "hr\tef=",
+    "href", "=", "\"", "'", ">", "#", "#top", " ", "\n", "page.html", "/root.html", "../up.html",
+    "x y", "http://cs50tse.cs.dartmouth.edu/tse/", "HTTPS://other.org/", "ht tp://a.b/", "mailto:me",
+    ":", "?q=1", "/", "text", NULL
+};
+
+// function prototypes
+static void randomHTML(char* html);
+static int checkPage(webpage_t* page, const char* name);
+static char* nextURL(char* html, const char* base, int* pos);
+static char* resolve(const char* base, const char* rel, const size_t len);
+
+/* ********************* main ************************ */
+int main(const int argc, char* argv[]){
+
+    const char* edges[] = {                 //html for white space and malformed links
+        "",
+        "<a href=\"page.html\">page</a>",
+        "<a href='/root.html'>root</a> <A HREF=http://cs50tse.cs.dartmouth.edu/tse/x.html>x</A>",
+        "< a\n href = \" spaced out.html \" >spaces</a>",
+        "<a\thr ef\n=\n'\nsplit.html'>split</a>",
+        "<a href=\"#top\">internal</a><a href=\"page.html#part\">fragment</a>",
+        "<a href=\"mailto:me@example.com\">mail</a><a href=\"https://other.org/\">secure</a>",
+        "<a name=x>no href here</a> <b href=\"b.html\">not a link</b> <a href=\"after.html\">",
+        "<abbr title=x>abbreviation</abbr> <area href=\"area.html\">",
+        "<a href=\"unterminated.html>never closed",
+        "<a href=unquoted.html name=val>unquoted</a>",
+        "<a href=\"one.html\"><a href=\"two.html\"><a href=\"three.html\">",
+        "text before <a <a <a href=\"last.html\"> and after",
+        "<a href=\"what:is/this\">colon</a><a href=\"ht tp://spaced.org/\">spaced scheme</a>",
+        "<a\r\n\v\fhref=\"white.html\">every kind of white space</a>",
+        NULL
+    };
+
+    exit(pagecheck_main(argc, argv, "links", BASEURL, edges, randomHTML, checkPage));
+}
+
+/**************** randomHTML ****************/
+/*
+* Output: html, a random string of up to MAXPIECES pieces
+*/
+static void randomHTML(char* html){
+    static int numPieces = 0;
+    while(PIECES[numPieces] != NULL){
+        numPieces++;
+    }
+
+    html[0] = '\0';
+    for(int j = rand() % (MAXPIECES + 1); j > 0; j--){
+        strcat(html, PIECES[rand() % numPieces]);
+    }
+}
+
+/**************** checkPage ****************/
+/*
+* Input: webpage to check, and its name for printing
+*
+* Finds the links of the page with both webpage_getNextURL and nextURL, the latter
+* on a copy of the html without white space, comparing each link and printing
+* the first difference.
+*
+* Returns: number of links found, or -1 if the two differed
+*/
+static int checkPage(webpage_t* page, const char* name){
+    const char* html = webpage_getHTML(page);
+    char* condensed = mem_malloc_assert(strlen(html) + 1, "html");
+    int pos = 0, oldPos = 0;                //positions of the two extractors
+    char* url;                              //link webpage_getNextURL found
+    char* oldURL;                           //link nextURL found
+    int links = 0;                          //links found
+    int n = 0;                              //chars of condensed
+    bool more = true;                       //are there more links to compare?
+
+    for(int i = 0; html[i] != '\0'; i++){
+        if(!isspace(html[i])){
+            condensed[n++] = html[i];
+        }
+    }
+    condensed[n] = '\0';
+
+    do{
+        url = webpage_getNextURL(page, &pos);
+        oldURL = nextURL(condensed, webpage_getURL(page), &oldPos);
+        if((url == NULL) != (oldURL == NULL) || (url != NULL && strcmp(url, oldURL) != 0)){
+            printf("%s: link %d differs: found %s; expected %s\n", name, links + 1,
+                   url == NULL ? "(none)" : url, oldURL == NULL ? "(none)" : oldURL);
+            links = -1;
+        }
+        else{
+            links += url != NULL;
+        }
+        more = links >= 0 && url != NULL;
+        free(url);
+        free(oldURL);
+    } while(more);
+
+    mem_free(condensed);
+    return links;
+}
+
+/**************** nextURL ****************/
+/*
+* The link extractor of webpage_getNextURL before it stopped removing white space,
+* courtesy of Ray Jenkins and/or Charles Palmer, cleaned by David Kotz;
+* changed only to take html whose white space is already removed, and to make
+* relative links absolute with resolve, since fixRelativeURL is private to webpage.c.
+*
+* Returns: the next link in html at or after *pos, moving *pos past it, or NULL if there is none
+*/
+static char* nextURL(char* html, const char* base, int* pos){
+    int bad_link;                            // is this link ill formatted?
+    int relative;                            // is this link relative?
+    char delim;                              // url delimiter: ''', '"'
+    char* lnk;                               // hyperlink tags
+    char* href;                              // href in a tag
+    char* end;                               // end of hyperlink tag or url
+    char* ptr;                               // absolute vs. relative
+    char* hash;                              // hash mark character
+
+    // parse for hyperlinks
+    do {
+        relative = 0;                        // assume absolute link
+        bad_link = 0;                        // assume valid link
+
+        // find tag "<a" or "<A""
+        lnk = strcasestr(&html[*pos], "<a");
+
+        // no more links on this page
+        if (!lnk) { return NULL; }
+
+        // find next href after hyperlink tag
+        href = strcasestr(lnk, "href=");
+
+        // no more links on this page
+        if (!href) { return NULL; }
+
+        // find end of hyperlink tag
+        end = strchr(lnk, '>');
+
+        // if the href we have is outside the current tag, continue
+        if (end && (end < href)) {
+            bad_link = 1; (*pos) += 2; continue;
+        }
+
+        // move href to beginning of url
+        href+=5;
+
+        // is the url quoted?
+        if (*href == '\'' || *href == '"') {  // yes, href="url" or href='url'
+            delim = *(href++);               // remember delimiter
+            end = strchr(href, delim);       // find next of same delimiter
+        } else {             // no, href=url
+            end = strchr(href, '>');         // hope: <a ... href=url>
+        }
+
+        // if there is a # before the end of the url, exclude the #fragment
+        hash = strchr(href, '#');
+        if (hash && end && hash < end) {
+            end = hash;
+        }
+
+        // if we don't know where to end the url, continue
+        if (!end) {
+            bad_link = 1; (*pos) += 2; continue;
+        }
+
+        // have a link now
+        if (*href == '#') {                   // internal reference
+            bad_link = 1; (*pos) += 2; continue;
+        }
+
+        // is the url absolute, i.e, ':' must precede any '/', '?', or '#'
+        ptr = strpbrk(href, ":/?#");
+        if (!ptr || *ptr != ':') {
+            relative = 1;
+        } else if (strncasecmp(href, "http", 4)) { // absolute, but not http(s)
+            bad_link = 1; (*pos) += 2; continue;
+        }
+    } while (bad_link);                       // keep parsing
+
+    // update position after the end of the url
+    *pos = end - html;
+
+    // have a good link now
+    if (relative) {                           // need to fixup relative links
+        return resolve(base, href, end - href);
+    } else {
+        // create new buffer
+        char* result = calloc(end-href+1, sizeof(char));
+        if (result != NULL) {
+            strncpy(result, href, end - href);
+        }
+        return result;
+    }
+}
+
+/**************** resolve ****************/
+/*
+* Makes the relative link of len chars at rel absolute, as fixRelativeURL would,
+* by asking webpage_getNextURL for the link of a page at base holding only it.
+* A relative link has no white space or '#', and nothing in it or after it makes
+* the page's link look absolute, so both extractors agree on such a page.
+*
+* Returns: the absolute link, to be free()d, or NULL if it cannot be made
+*/
+static char* resolve(const char* base, const char* rel, const size_t len){
+    char* html = mem_malloc_assert(len + 16, "html");
+    char* url = mem_malloc_assert(strlen(base) + 1, "url");
+    int pos = 0;
+
+    //quote the link with a delimiter it does not hold; holding both, it was unquoted, so holds no '>'
+    if(memchr(rel, '"', len) == NULL){
+        sprintf(html, "<a href=\"%.*s\">", (int)len, rel);
+    }
+    else if(memchr(rel, '\'', len) == NULL){
+        sprintf(html, "<a href='%.*s'>", (int)len, rel);
+    }
+    else{
+        sprintf(html, "<a href=%.*s>", (int)len, rel);
+    }
+    strcpy(url, base);
+
+    webpage_t* page = mem_assert(webpage_new(url, 0, html), "webpage");
+    char* result = webpage_getNextURL(page, &pos);
+    webpage_delete(page);
+    return result;
+}
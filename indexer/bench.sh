@@ -0,0 +1,34 @@
+#!/bin/bash
+#
+# Bash benchmark script for indexer.c
+#
+# usage: bash bench.sh benchDirectory "numPages..." resultsFile [pagegenOptions...]
+#
+# For each number of pages, writes a synthetic pageDirectory of that many pages with pagegen
+# into benchDirectory/numPages, unless it is already there, then indexes it with indexer -t and
+# records in resultsFile the time of each phase of indexBuild, the peak RSS, and a checksum of
+# the index. pagegen always writes the same pages for the same options, so results files from
+# two commits can be diffed: the checksums should match, and the timings show what got faster.
+# Any further arguments are passed to pagegen, e.g. -v 50000 -z 1.1.
+
+if [ $# -lt 3 ]; then
+    echo "usage: bash bench.sh benchDirectory \"numPages...\" resultsFile [pagegenOptions...]" >&2
+    exit 2
+fi
+benchDirectory=$1
+sizes=$2
+results=$3
+shift 3
+
+echo "# indexer benchmark of pagegen $* pages" > "$results"
+for numPages in $sizes; do
+    pageDirectory=$benchDirectory/$numPages
+    if [ ! -f "$pageDirectory/.crawler" ] || [ ! -f "$pageDirectory/$numPages" ]; then
+        mkdir -p "$pageDirectory" || exit 1
+        ./pagegen "$@" "$pageDirectory" "$numPages" || exit 1
+    fi
+    echo "pages $numPages" >> "$results"
+    ./indexer -t "$pageDirectory" "$benchDirectory/$numPages.index" 2>> "$results" || exit 1
+    echo "index $(cksum < "$benchDirectory/$numPages.index")" >> "$results"
+done
+cat "$results"
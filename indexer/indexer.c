@@ -5,6 +5,11 @@
  * Written with consultation of CS50 knowledge pages and using methods from libcs50
  * 
  * Indexer takes two arguements, a pageDirectory, and an indexFilename
+ *     indexer [-j numThreads] [-b] [-t] pageDirectory indexFilename
+ * numThreads, if given, must be between 1 and 64; it defaults to 1.
+ * With -b, the index file is written in the binary format of indexmap.h instead of as text.
+ * With -t, indexer times each phase of building the index, and prints the times and its
+ * peak resident memory to stderr; see indextimes_t.
  * 
  * It will read webpages from the pagedirecting, counting the occurences of words or three
  * or more letters in each, and creating an index data structure to store that information.
@@ -14,39 +19,96 @@
  * The pageDirectory must be readable and must have been created by crawler
  * indexFilename must point to a writeable file
  * 
+ * With -j, indexer runs numThreads worker threads that each take the next docID,
+ * load that page and count its words into a private index, so pages are indexed in parallel.
+ * Only handing out docIDs is shared, under the index lock; the private indexes are
+ * merged into one once all pages are indexed, so the index file holds the same lines.
+ * 
+ * Indexer also writes the URL of every page it indexed to pageDirectory/.urls (see urltable.h),
+ * so querier can find them without opening each page file, even for older crawls.
+ * 
  * Written with consultation of CS50 knowledge units and functions provided by libcs50.
  * 
  * Jack McMahon, February 14th 2022
  */
 
+/* clock_gettime is POSIX, not C11 */
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/resource.h>
 #include "../libcs50/mem.h"
 #include "../libcs50/webpage.h"
 #include "../libcs50/counters.h"
 #include "../libcs50/hashtable.h"
+#include "../libcs50/arena.h"
 #include "../common/pagedir.h"
 #include "../common/index.h"
-#include "../common/word.h"
+#include "../common/indexmap.h"
+#include "../common/urltable.h"
+
+/**************** global types ****************/
+// seconds spent in each phase of building the index, with -t
+typedef struct indextimes {
+    double count;               // counting the pages
+    double load;                // loading the page files, summed over the workers
+    double tokenize;            // finding and normalizing their words, summed over the workers
+    double insert;              // counting the words into the indexes, summed over the workers
+    double workers;             // from starting the workers until the last has finished
+    double merge;               // merging the workers' indexes into one
+    double urls;                // writing the URL table
+    double write;               // writing the index file
+} indextimes_t;
+
+// a word found in a page's html by webpage_getNextWordSpan, not yet lowercased
+typedef struct wordspan {
+    const char* word;           // first character of the word, in the page's html
+    int length;                 // number of characters in the word
+} wordspan_t;
+
+// state shared by all index workers; everything but the constants is guarded by lock
+typedef struct indexstate {
+    char* pageDirectory;        // directory to load pages from
+    int numPages;               // last docID in pageDirectory
+    int docID;                  // next docID to index
+    char** urls;                // URL of each docID, from 1; each worker fills in its own docIDs
+    indextimes_t* times;        // times of the phases, or NULL if not timing; workers add theirs
+    pthread_mutex_t lock;       // guards the fields above
+} indexstate_t;
+
+static const int MAXTHREADS = 64;   // maximum number of index workers
+static const size_t SCRATCHSIZE = 16384;    // bytes in each block of a worker's scratch arena
 
 // function prototypes
-static void parseArgs(const int argc, char* argv[],
-                      char** pageDirectory, char** indexFilename);
-static void indexBuild(char* pageDirectory, char* indexFilename);
-static void indexPage(index_t* index, webpage_t* page, const int docID);
+static void parseArgs(const int argc, char* argv[], char** pageDirectory, char** indexFilename,
+                      int* numThreads, bool* binary, bool* timed);
+static void indexBuild(char* pageDirectory, char* indexFilename, const int numThreads,
+                       const bool binary, const bool timed);
+static void* indexWorker(void* arg);
+static void indexPage(index_t* index, webpage_t* page, const int docID, arena_t* scratch,
+                      indextimes_t* times);
+static void indexWord(index_t* index, const char* word, const int length, const int docID);
+static void printTimes(indextimes_t* times, const double total, const int numThreads);
+static double now(void);
 
 /* ********************* main ************************ */
 int main(const int argc, char* argv[]){
 
     char* pageDirectory; //Directory that we will writefiles to for each crawled webpage
     char* indexFilename; //File name for the index file we will write
+    int numThreads = 1; //number of pages to index at once
+    bool binary = false; //whether to write a binary index file
+    bool timed = false;  //whether to time the phases of building the index
 
     //parse arguments to check if they match correct input type, if so assign to variables
-    parseArgs(argc, argv, &pageDirectory, &indexFilename);
+    parseArgs(argc, argv, &pageDirectory, &indexFilename, &numThreads, &binary, &timed);
 
     //crawl pages and add them to pageDirectory
-    indexBuild(pageDirectory, indexFilename);
+    indexBuild(pageDirectory, indexFilename, numThreads, binary, timed);
     
     //free memory at the end
     mem_free(pageDirectory);
@@ -56,20 +118,49 @@ int main(const int argc, char* argv[]){
 
 /**************** parseArgs ****************/
 /* 
-* Input: char* for page directory, char* for indexFilename
+* Input: char* for page directory, char* for indexFilename, int for number of threads,
+*        bool for binary index file, bool for timing the phases
  * 
  * Makes sure arguments match the given specifications, if so then assigns them to variables
+ * The optional -j numThreads, -b and -t come before the two required arguments.
 */
-static void parseArgs(const int argc, char* argv[],
-                      char** pageDirectory, char** indexFilename){
-    if(argc != 3){
+static void parseArgs(const int argc, char* argv[], char** pageDirectory, char** indexFilename,
+                      int* numThreads, bool* binary, bool* timed){
+    int arg = 1; //index of the first required argument
+
+    //check for the optional -j numThreads, -b and -t
+    while(arg < argc && argv[arg][0] == '-'){
+        if(strcmp(argv[arg], "-j") == 0){
+            if(arg + 1 >= argc || (*numThreads = atoi(argv[arg + 1])) < 1 || *numThreads > MAXTHREADS){
+                //throw error if thread count is missing or out of bounds
+                fprintf(stderr, "Number of threads must be between 1 and %d.\n", MAXTHREADS);
+                exit(7);
+            }
+            arg += 2;
+        }
+        else if(strcmp(argv[arg], "-b") == 0){
+            *binary = true;
+            arg++;
+        }
+        else if(strcmp(argv[arg], "-t") == 0){
+            *timed = true;
+            arg++;
+        }
+        else{
+            //throw error if unknown option
+            fprintf(stderr, "Unknown option %s.\n", argv[arg]);
+            exit(1);
+        }
+    }
+
+    if(argc - arg != 2){
         //throw error if incorrect number of arguments
         fprintf(stderr, "Incorrect number of arguments.\n");
         exit(1);
     }
 
-    *pageDirectory = mem_malloc_assert((strlen(argv[1]) + 1), "pageDirectory");
-    strcpy(*pageDirectory, argv[1]);
+    *pageDirectory = mem_malloc_assert((strlen(argv[arg]) + 1), "pageDirectory");
+    strcpy(*pageDirectory, argv[arg]);
 
     if ( ! pagedir_validate(*pageDirectory)) {
         //throw error if can't write in  given page directory
@@ -78,8 +169,8 @@ static void parseArgs(const int argc, char* argv[],
     }
 
     FILE* fp;
-    *indexFilename = mem_malloc_assert((strlen(argv[2]) + 1), "indexFilename");
-    strcpy(*indexFilename, argv[2]);
+    *indexFilename = mem_malloc_assert((strlen(argv[arg + 1]) + 1), "indexFilename");
+    strcpy(*indexFilename, argv[arg + 1]);
 
     //check if the index file specified by indexFilename is writeable
     if((fp = fopen(*indexFilename, "w")) != NULL) {
@@ -95,86 +186,264 @@ static void parseArgs(const int argc, char* argv[],
 
 /**************** indexBuild ****************/
 /* 
-* Input: char* for page directory
+* Input: char* for page directory, char* for indexFilename, int for number of threads,
+*        bool for binary index file, bool for timing the phases
 * 
-* Creates an index structure, loops through webpage files in pageDIrectory
-* Calls indexPage to count words in each webpage file and add them to the index
-* prints the index to a file specified by indexFilename.
+* Counts the webpage files in pageDirectory, then runs numThreads indexWorkers
+* that call indexPage to count words in each webpage file into their own index.
+* Merges those into one index and prints it to a file specified by indexFilename,
+* as text or, if binary, in the format of indexmap.h.
+* If timed, prints to stderr the time each phase took.
  *
 * Returns: nothing
 */
-static void indexBuild(char* pageDirectory, char* indexFilename)
+static void indexBuild(char* pageDirectory, char* indexFilename, const int numThreads,
+                       const bool binary, const bool timed)
 {
+    indexstate_t state;         //state shared by the workers
     index_t* invertedIndex;     //holds inverted index of words in the pageDirectory
-    const int SLOTS = 300;      //number of index slots
-    int docID = 1;              //increments docID
-    webpage_t* current = NULL;         //stores current webpage
-    FILE* fp;                   //stores the webpage to be sent to pagedir_load
+    index_t* partialIndex;      //holds inverted index of the pages one worker indexed
+    void* result;               //what a worker returned, its index
+    pthread_t* workers;         //worker threads
+    FILE* fp;                   //stores the index file to write
+    indextimes_t times = {0};   //time of each phase
+    double start = now();       //when building began
+    double phase = start;       //when the current phase began
 
-    invertedIndex = mem_assert(index_new(SLOTS), "inverted index\n");
+    state.pageDirectory = pageDirectory;
+    state.numPages = pagedir_count(pageDirectory);
+    state.docID = 1;
+    state.times = timed ? &times : NULL;
+    pthread_mutex_init(&state.lock, NULL);
+    times.count = now() - phase;
 
-    //load each page in pageDirectory by incrementing docID
-    while(true){
-        if(docID == 1){
-            if(pagedir_load(&current, pageDirectory, docID)){
-                indexPage(invertedIndex, current, docID);
-                docID++;
-            }
-            else{
-                //unrecoverable error if cant open the first file to read
-                fprintf(stderr, "Cannot open first file in %s for reading\n", pageDirectory);
-                exit(11);
-            }
-        }
-        else if(pagedir_load(&current, pageDirectory, docID)){
-            indexPage(invertedIndex, current, docID);
-            docID++;
-        }
-        else{
-            //we've reached the last webpage file in pageDirectory
-            break;
+    if(state.numPages == 0){
+        //unrecoverable error if cant open the first file to read
+        fprintf(stderr, "Cannot open first file in %s for reading\n", pageDirectory);
+        exit(11);
+    }
+    state.urls = mem_calloc_assert(state.numPages, sizeof(char*), "urls");
+
+    //index with numThreads workers; with one worker this is the plain sequential build
+    phase = now();
+    workers = mem_malloc_assert(numThreads * sizeof(pthread_t), "workers");
+    for (int t = 0; t < numThreads; t++) {
+        if (pthread_create(&workers[t], NULL, indexWorker, &state) != 0) {
+            fprintf(stderr, "Cannot create index thread\n");
+            exit(13);
         }
     }
+
+    //merge each worker's index into the first one, timing the merges apart from the waiting
+    pthread_join(workers[0], &result);
+    invertedIndex = result;
+    for (int t = 1; t < numThreads; t++) {
+        pthread_join(workers[t], &result);
+        partialIndex = result;
+        double merge = now();
+        index_merge(invertedIndex, partialIndex);
+        index_delete(partialIndex, (void(*)(void*))counters_delete);
+        times.merge += now() - merge;
+    }
+    times.workers = now() - phase - times.merge;
+    mem_free(workers);
+    pthread_mutex_destroy(&state.lock);
+
+    //record the URL of each page for querier; the index is still good without it
+    phase = now();
+    if(!urltable_write(pageDirectory, state.urls, state.numPages)){
+        fprintf(stderr, "Cannot write URL table to %s\n", pageDirectory);
+    }
+    for(int i = 0; i < state.numPages; i++){
+        mem_free(state.urls[i]);
+    }
+    mem_free(state.urls);
+    times.urls = now() - phase;
+
+    phase = now();
     fp = fopen(indexFilename, "w");
 
     //print the inverted index to indexFilename
-    index_write(invertedIndex, fp);
+    if(binary){
+        if(!indexmap_write(invertedIndex, fp)){
+            fprintf(stderr, "Cannot write %s\n", indexFilename);
+            exit(23);
+        }
+    }
+    else{
+        index_write(invertedIndex, fp);
+    }
+    fclose(fp);
+    times.write = now() - phase;
+
+    if(timed){
+        printTimes(&times, now() - start, numThreads);
+    }
 
     //delete the inverted index
     index_delete(invertedIndex, (void(*)(void*))counters_delete);
+}
 
-    fclose(fp);
-    
+/**************** indexWorker ****************/
+/* 
+* Input: indexstate_t* shared by all workers, as a void* for pthread_create
+* 
+* Loops taking the next docID until every page has been handed out,
+* loading each webpage file, noting its URL, and counting its words into an index of its own.
+* Memory needed only while indexing one page comes from an arena of the worker's own,
+* reset after each page, so the worker does not call malloc and free for it page after page.
+* Only taking the docID happens under the lock; no other worker has the same docID's URL slot.
+* If the state has times, adds this worker's times of the load, tokenize and insert phases to them.
+*
+* Returns: index_t* of the pages this worker indexed, for the caller to merge and delete
+*/
+static void* indexWorker(void* arg)
+{
+    indexstate_t* state = arg;  //state shared by the workers
+    const int SLOTS = 300;      //number of index slots
+    index_t* invertedIndex;     //holds inverted index of the pages this worker loads
+    webpage_t* current = NULL;  //stores current webpage
+    int docID;                  //docID of the current webpage
+    arena_t* scratch;           //memory for the current webpage only
+    indextimes_t times = {0};   //this worker's times
+    double phase = 0;           //when loading the current page began
+
+    invertedIndex = mem_assert(index_new(SLOTS), "inverted index\n");
+    scratch = mem_assert(arena_new(SCRATCHSIZE), "scratch arena\n");
+
+    while(true){
+        pthread_mutex_lock(&state->lock);
+        docID = state->docID++;
+        pthread_mutex_unlock(&state->lock);
+
+        if(state->times != NULL){
+            phase = now();
+        }
+        if(docID > state->numPages || !pagedir_load(&current, state->pageDirectory, docID, scratch)){
+            //every page has been handed out
+            break;
+        }
+        state->urls[docID - 1] = mem_malloc_assert(strlen(webpage_getURL(current)) + 1, "url");
+        strcpy(state->urls[docID - 1], webpage_getURL(current));
+        if(state->times != NULL){
+            times.load += now() - phase;
+        }
+        indexPage(invertedIndex, current, docID, scratch, state->times != NULL ? &times : NULL);
+        arena_reset(scratch);
+    }
+    arena_delete(scratch);
+
+    if(state->times != NULL){
+        pthread_mutex_lock(&state->lock);
+        state->times->load += times.load;
+        state->times->tokenize += times.tokenize;
+        state->times->insert += times.insert;
+        pthread_mutex_unlock(&state->lock);
+    }
+    return invertedIndex;
 }
 
 /**************** indexPage ****************/
 /* 
-* Input: index_t* for index, webpage_t* for webpage to be added to the index, int for docID
+* Input: index_t* for index, webpage_t* for webpage to be added to the index, int for docID,
+*        arena_t* for memory needed only while indexing this page,
+*        indextimes_t* to add the tokenize and insert times to, or NULL if not timing
 * 
-* Scans a webpage file for words which are counted using an index data structure
+* Scans a webpage file for words which are counted using an index data structure.
+* Words are found in place in the page's html, so a word is only copied if it is new to the index.
+* To time finding the words apart from counting them, it first finds all the words of the page,
+* then counts them all; otherwise it counts each word as it finds it.
 * 
 * Returns: nothing
 */
-static void indexPage(index_t* invertedIndex, webpage_t* page, const int docID)
+static void indexPage(index_t* invertedIndex, webpage_t* page, const int docID, arena_t* scratch,
+                      indextimes_t* times)
 {
     mem_assert(invertedIndex, "index");
     mem_assert(page, "webpage in indexpage");
-    int pos = 0; //tracks position of word for weppage_getNextWord
-    char* result; //stores normalized word
-
-    //loops through each word in the webpage
-    while ((result = webpage_getNextWord(page, &pos)) != NULL) {
-        //normalize the word by converting to lowercase
-        word_normalize(result);
-        if(strlen(result) > 2){
-            if (index_find(invertedIndex, result) == NULL){
-                 //if the word is not in the inverted index then add it
-                index_insert(invertedIndex, result);
+    int pos = 0; //tracks position of word for webpage_getNextWordSpan
+    int length; //length of the word found
+    const char* word; //word found, in the page's html
+
+    if(times == NULL){
+        //loops through each word in the webpage
+        while ((word = webpage_getNextWordSpan(page, &pos, &length)) != NULL) {
+            indexWord(invertedIndex, word, length, docID);
+        }
+    }
+    else{
+        int numWords = 0;           //words found in the page
+        int room = 64;              //words there is room for
+        wordspan_t* words = mem_assert(arena_alloc(scratch, room * sizeof(wordspan_t)), "words");
+        double phase = now();       //when the current phase began
+
+        while ((word = webpage_getNextWordSpan(page, &pos, &length)) != NULL) {
+            if(numWords == room){
+                //the old array stays in scratch until the caller resets it
+                wordspan_t* more = mem_assert(arena_alloc(scratch, 2 * room * sizeof(wordspan_t)), "words");
+                memcpy(more, words, room * sizeof(wordspan_t));
+                words = more;
+                room *= 2;
             }
-        // increment the count of the word for the given docID
-        index_increment(invertedIndex, result, docID);
+            words[numWords].word = word;
+            words[numWords++].length = length;
         }
-        mem_free(result);
+        times->tokenize += now() - phase;
+
+        phase = now();
+        for(int i = 0; i < numWords; i++){
+            indexWord(invertedIndex, words[i].word, words[i].length, docID);
+        }
+        times->insert += now() - phase;
     }
     webpage_delete(page);
-}
\ No newline at end of file
+}
+
+/**************** indexWord ****************/
+/* 
+* Input: index_t* for index, a word of length chars found by webpage_getNextWordSpan, int for docID
+* 
+* Counts one more of the word, normalized, in docID, if it has more than two letters,
+* inserting the word into the index first if it is new; index_upsert lowercases, hashes,
+* and looks up the word in a single pass and probe.
+*/
+static void indexWord(index_t* invertedIndex, const char* word, const int length, const int docID)
+{
+    if(length > 2 && index_upsert(invertedIndex, word, length, docID) == 0){
+        mem_assert(NULL, "index upsert");
+    }
+}
+
+/**************** printTimes ****************/
+/* 
+* Prints to stderr the time of each phase of building the index, the total,
+* and the peak resident memory of the indexer
+*/
+static void printTimes(indextimes_t* times, const double total, const int numThreads)
+{
+    struct rusage usage;        //holds peak resident memory
+
+    fprintf(stderr, "Phases (seconds; load, tokenize and insert summed over %d threads):\n", numThreads);
+    fprintf(stderr, "  count     %9.3f\n", times->count);
+    fprintf(stderr, "  load      %9.3f\n", times->load);
+    fprintf(stderr, "  tokenize  %9.3f\n", times->tokenize);
+    fprintf(stderr, "  insert    %9.3f\n", times->insert);
+    fprintf(stderr, "  workers   %9.3f\n", times->workers);
+    fprintf(stderr, "  merge     %9.3f\n", times->merge);
+    fprintf(stderr, "  urls      %9.3f\n", times->urls);
+    fprintf(stderr, "  write     %9.3f\n", times->write);
+    fprintf(stderr, "  total     %9.3f\n", total);
+    if(getrusage(RUSAGE_SELF, &usage) == 0){
+        fprintf(stderr, "Peak RSS: %ld KB\n", usage.ru_maxrss);
+    }
+}
+
+/**************** now ****************/
+/* Returns: seconds on the monotonic clock, for timing phases */
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
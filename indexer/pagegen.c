@@ -0,0 +1,210 @@
+/*
+ * pagegen.c
+ *
+ * Writes a synthetic pageDirectory, in the format crawler writes, for benchmarking
+ * indexer at any size without a network or a web server to crawl.
+ *
+ * pagegen takes two arguments, a pageDirectory and a number of pages
+ *     pagegen [-v vocabSize] [-w wordsPerPage] [-z exponent] [-s seed] pageDirectory numPages
+ * vocabSize, the number of distinct words, must be at least 1; it defaults to 10000.
+ * wordsPerPage must be at least 1; it defaults to 200.
+ * exponent, of the Zipf distribution of words, must be at least 0; it defaults to 1.0.
+ * seed, for the random numbers, must be at least 0; it defaults to 1.
+ *
+ * Input Specifications:
+ * The pageDirectory must be an existing, writable directory.
+ *
+ * pagegen marks pageDirectory with a .crawler file, then writes page files 1 to numPages,
+ * each holding a URL, a depth, and HTML of wordsPerPage words with a few links to other pages.
+ * The word of rank r, counting from 1, is drawn with probability proportional to 1/r^exponent,
+ * as words of natural text roughly are; exponent 0 draws all words equally often.
+ * Each word is its rank written in base 26 with the letters a to z, at least three letters
+ * long so that indexer counts it. The same arguments always write the same pages.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../libcs50/mem.h"
+#include "../libcs50/webpage.h"
+#include "../common/pagedir.h"
+
+/**************** file-local global variables ****************/
+static const int WORDSPERLINE = 12;     // words on each line of a page's HTML
+static const int LINKSPERPAGE = 3;      // links on each page to other pages
+static const int MAXWORD = 16;          // room for the longest word, with its null
+
+// function prototypes
+static void parseArgs(const int argc, char* argv[], char** pageDirectory, int* numPages,
+                      int* vocabSize, int* wordsPerPage, double* exponent, int* seed);
+static double* zipfTable(const int vocabSize, const double exponent);
+static int drawRank(const double* cdf, const int vocabSize);
+static void rankWord(int rank, char* word);
+static char* makeHTML(const double* cdf, const int vocabSize, const int wordsPerPage,
+                      const int numPages, const int docID);
+
+/* ********************* main ************************ */
+int main(const int argc, char* argv[]){
+
+    char* pageDirectory;        //directory to write the pages into
+    int numPages;               //pages to write
+    int vocabSize = 10000;      //distinct words to draw from
+    int wordsPerPage = 200;     //words on each page
+    double exponent = 1.0;      //exponent of the Zipf distribution of words
+    int seed = 1;               //seed for the random numbers
+    double* cdf;                //cumulative probability of each word rank
+    char* url;                  //URL of the current page
+
+    parseArgs(argc, argv, &pageDirectory, &numPages, &vocabSize, &wordsPerPage, &exponent, &seed);
+
+    if(!pagedir_init(pageDirectory)){
+        fprintf(stderr, "Cannot write to %s\n", pageDirectory);
+        exit(2);
+    }
+
+    srand(seed);
+    cdf = zipfTable(vocabSize, exponent);
+    for(int docID = 1; docID <= numPages; docID++){
+        //webpage_new adopts url and html, which webpage_delete frees with free
+        url = mem_assert(malloc(64), "url");
+        sprintf(url, "http://synthetic.test/%d.html", docID);
+        webpage_t* page = mem_assert(webpage_new(url, docID == 1 ? 0 : 1,
+                                                 makeHTML(cdf, vocabSize, wordsPerPage, numPages, docID)),
+                                     "webpage");
+        pagedir_save(page, pageDirectory, docID, NULL);
+        webpage_delete(page);
+    }
+
+    mem_free(cdf);
+    exit(0);
+}
+
+/**************** parseArgs ****************/
+/*
+ * Makes sure arguments match the given specifications, if so then assigns them to variables.
+ * The optional -v, -w, -z and -s come before the two required arguments.
+ * The pageDirectory is left in argv, not copied.
+*/
+static void parseArgs(const int argc, char* argv[], char** pageDirectory, int* numPages,
+                      int* vocabSize, int* wordsPerPage, double* exponent, int* seed){
+    int arg = 1; //index of the first required argument
+
+    while(arg < argc && argv[arg][0] == '-'){
+        if(arg + 1 >= argc){
+            fprintf(stderr, "Missing value for %s.\n", argv[arg]);
+            exit(1);
+        }
+        if(strcmp(argv[arg], "-v") == 0 && (*vocabSize = atoi(argv[arg + 1])) >= 1){
+            arg += 2;
+        }
+        else if(strcmp(argv[arg], "-w") == 0 && (*wordsPerPage = atoi(argv[arg + 1])) >= 1){
+            arg += 2;
+        }
+        else if(strcmp(argv[arg], "-z") == 0 && (*exponent = atof(argv[arg + 1])) >= 0){
+            arg += 2;
+        }
+        else if(strcmp(argv[arg], "-s") == 0 && (*seed = atoi(argv[arg + 1])) >= 0){
+            arg += 2;
+        }
+        else{
+            //throw error if unknown option, or a value out of range
+            fprintf(stderr, "Bad option %s %s.\n", argv[arg], argv[arg + 1]);
+            exit(1);
+        }
+    }
+
+    if(argc - arg != 2 || (*numPages = atoi(argv[arg + 1])) < 1){
+        fprintf(stderr, "usage: pagegen [-v vocabSize] [-w wordsPerPage] [-z exponent] [-s seed] "
+                        "pageDirectory numPages\n");
+        exit(1);
+    }
+    *pageDirectory = argv[arg];
+}
+
+/**************** zipfTable ****************/
+/*
+* Returns: a new array of the cumulative probability of drawing each rank from 0 to vocabSize-1,
+* rank r having weight 1/(r+1)^exponent; the caller must mem_free it
+*/
+static double* zipfTable(const int vocabSize, const double exponent){
+    double* cdf = mem_malloc_assert(vocabSize * sizeof(double), "zipf table");
+    double sum = 0;
+
+    for(int r = 0; r < vocabSize; r++){
+        sum += 1.0 / pow(r + 1, exponent);
+        cdf[r] = sum;
+    }
+    for(int r = 0; r < vocabSize; r++){
+        cdf[r] /= sum;
+    }
+    return cdf;
+}
+
+/**************** drawRank ****************/
+/*
+* Returns: a random rank from 0 to vocabSize-1, by binary search of the cumulative probabilities
+* for the first rank whose cumulative probability passes a uniform random number
+*/
+static int drawRank(const double* cdf, const int vocabSize){
+    double u = rand() / (RAND_MAX + 1.0);
+    int low = 0;
+    int high = vocabSize - 1;
+
+    while(low < high){
+        int mid = low + (high - low) / 2;
+        if(cdf[mid] <= u){
+            low = mid + 1;
+        }
+        else{
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**************** rankWord ****************/
+/*
+* Writes into word, which has room for MAXWORD chars, the word for a rank:
+* its base-26 digits, least significant first, as the letters a to z, padded with 'a'
+* to three letters. Distinct ranks give distinct words.
+*/
+static void rankWord(int rank, char* word){
+    int length = 0;
+
+    do{
+        word[length++] = 'a' + rank % 26;
+        rank /= 26;
+    } while(rank > 0);
+    while(length < 3){
+        word[length++] = 'a';
+    }
+    word[length] = '\0';
+}
+
+/**************** makeHTML ****************/
+/*
+* Returns: new HTML for page docID, with a title, wordsPerPage words drawn from cdf in lines of
+* WORDSPERLINE, and LINKSPERPAGE links to the following pages; malloc'd, for webpage_new to adopt
+*/
+static char* makeHTML(const double* cdf, const int vocabSize, const int wordsPerPage,
+                      const int numPages, const int docID){
+    size_t size = 256 + (size_t)wordsPerPage * MAXWORD + LINKSPERPAGE * 128;
+    char* html = mem_assert(malloc(size), "html");
+    char word[MAXWORD];
+    size_t length;
+
+    length = sprintf(html, "<html>\n<head><title>Page %d</title></head>\n<body>\n<p>", docID);
+    for(int i = 0; i < wordsPerPage; i++){
+        rankWord(drawRank(cdf, vocabSize), word);
+        length += sprintf(html + length, "%s%s", word,
+                          (i + 1) % WORDSPERLINE == 0 || i + 1 == wordsPerPage ? "\n" : " ");
+    }
+    length += sprintf(html + length, "</p>\n");
+    for(int i = 1; i <= LINKSPERPAGE; i++){
+        length += sprintf(html + length, "<a href=\"http://synthetic.test/%d.html\">next</a>\n",
+                          (docID + i - 1) % numPages + 1);
+    }
+    sprintf(html + length, "</body>\n</html>\n");
+    return html;
+}
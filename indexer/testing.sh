@@ -32,6 +32,9 @@ myvalgrind='valgrind --leak-check=full --show-leak-kinds=all'
 #8: Test with invalid indexFile(existing, read-only file)
 ./indexer ../tse/output/wikipedia-1 ../index-data/test8.index
 
+#9: Test with invalid number of threads
+./indexer -j 0 ../tse/output/letters-2 ../index-data/test9.index
+
 #Test with indexTest validation****************************
 
 #1: Test with letters-2, indextest, then compare
@@ -62,6 +65,24 @@ myvalgrind='valgrind --leak-check=full --show-leak-kinds=all'
 
 ../tse/indexcmp ../index-data/wikipedia-1.index  ../index-data/wikipedia-1-indextest.index
 
+#5: Test with wikipedia-1 using 4 threads, then compare to the single-threaded index
+./indexer -j 4 ../tse/output/wikipedia-1 ../index-data/wikipedia-1-j4.index
+
+../tse/indexcmp ../index-data/wikipedia-1.index ../index-data/wikipedia-1-j4.index
+
+#6: Test timing the phases on a synthetic pageDirectory from pagegen, indextest, then compare
+mkdir -p ../index-data/pagegen-100
+./pagegen -v 500 -w 50 ../index-data/pagegen-100 100
+
+./indexer -t ../index-data/pagegen-100 ../index-data/pagegen-100.index
+
+./indextest ../index-data/pagegen-100.index ../index-data/pagegen-100-indextest.index
+
+../tse/indexcmp ../index-data/pagegen-100.index ../index-data/pagegen-100-indextest.index
+
+#7: Test the word scanner against the original tokenizer on the toscrape and wikipedia crawls
+./wordtest ../tse/output/toscrape-1 ../tse/output/toscrape-2 ../tse/output/wikipedia-1 ../tse/output/wikipedia-2
+
 #Test with valgrind***********************
 
 #1: Test with valgrind on indexer for letters10
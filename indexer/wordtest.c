@@ -0,0 +1,146 @@
+/*
+ * wordtest.c
+ *
+ * This is a tester for webpage_getNextWordSpan, which scans html many bytes at a time.
+ * It takes any number of arguments, each a pageDirectory or the URL of a page to fetch:
+ *          char*  pageDirectory or URL...
+ *
+ * Wordtest checks that webpage_getNextWordSpan finds exactly the words, and leaves exactly
+ * the positions, that the original byte-at-a-time tokenizer did, copied below as nextWord.
+ * The pages are checked by pagecheck, as urltest's are: html written to catch the edges of
+ * the scans (words and tags across 16-byte blocks, unclosed tags, bytes past ASCII),
+ * thousands of random html strings, then every page of each pageDirectory given, and each
+ * page fetched from a URL given.
+ *
+ * Prints how many pages and words matched, and exits 0 if all did; otherwise prints
+ * the first difference in each page that differed, and exits 1.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include "../libcs50/webpage.h"
+#include "../common/pagecheck.h"
+
+/**************** file-local global variables ****************/
+static const int MAXRANDOM = 80;        // longest random html string
+static const char RANDOMCHARS[] = "aZq< >/1\x80\xe9\n";     // chars the random strings draw from
+
+// function prototypes
+static void randomHTML(char* html);
+static int checkPage(webpage_t* page, const char* name);
+static const char* nextWord(const char* doc, int* pos, int* length);
+
+/* ********************* main ************************ */
+int main(const int argc, char* argv[]){
+
+    const char* edges[] = {                 //html for the edges of the scans
+        "",
+        "word",
+        "<b>",
+        "<b>tail",
+        "<unclosed tag at the end",
+        "text then <unclosed",
+        "ends right after a tag<br>",
+        "0123456789abcde<fghijklmnopqrstuvwxyz>ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789",
+        "0123456789012345word",
+        "012345678901234word",
+        "01234567890123456word",
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnop",
+        "@[`{ \x7f\x80\xc1\xe9\xff letters@between[brackets`and{braces",
+        "caf\xc3\xa9 na\xc3\xafve r\xc3\xa9sum\xc3\xa9 <p>\xe2\x80\x94" "dash</p>",
+        "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>words after",
+        "                                                       spaced out            ",
+        NULL
+    };
+
+    exit(pagecheck_main(argc, argv, "words", NULL, edges, randomHTML, checkPage));
+}
+
+/**************** randomHTML ****************/
+/*
+* Output: html, a random string of up to MAXRANDOM chars from RANDOMCHARS
+*/
+static void randomHTML(char* html){
+    int length = rand() % (MAXRANDOM + 1);
+    for(int j = 0; j < length; j++){
+        html[j] = RANDOMCHARS[rand() % (sizeof(RANDOMCHARS) - 1)];
+    }
+    html[length] = '\0';
+}
+
+/**************** checkPage ****************/
+/*
+* Input: webpage to check, and its name for printing
+*
+* Tokenizes the page with both webpage_getNextWordSpan and nextWord, comparing
+* each word and the position after it, and printing the first difference.
+*
+* Returns: number of words found, or -1 if the two differed
+*/
+static int checkPage(webpage_t* page, const char* name){
+    const char* doc = webpage_getHTML(page);
+    int pos = 0, oldPos = 0;                //positions of the two tokenizers
+    int length, oldLength;                  //lengths of the words they found
+    const char* word;                       //word webpage_getNextWordSpan found
+    const char* oldWord;                    //word nextWord found
+    int words = 0;                          //words found
+
+    do{
+        word = webpage_getNextWordSpan(page, &pos, &length);
+        oldWord = nextWord(doc, &oldPos, &oldLength);
+        if(word != oldWord || pos != oldPos || (word != NULL && length != oldLength)){
+            printf("%s: word %d differs: found %.*s at %ld, ending at %d; expected %.*s at %ld, ending at %d\n",
+                   name, words + 1, word == NULL ? 6 : length, word == NULL ? "(none)" : word,
+                   word == NULL ? -1L : (long)(word - doc), pos,
+                   oldWord == NULL ? 6 : oldLength, oldWord == NULL ? "(none)" : oldWord,
+                   oldWord == NULL ? -1L : (long)(oldWord - doc), oldPos);
+            return -1;
+        }
+        words += word != NULL;
+    } while(word != NULL);
+    return words;
+}
+
+/**************** nextWord ****************/
+/*
+* The tokenizer of webpage_getNextWord before it scanned many bytes at a time,
+* courtesy of Ray Jenkins and/or Charles Palmer, cleaned by David Kotz;
+* changed only to return the word in doc, and its length, rather than a copy.
+*
+* Returns: the next word in doc at or after *pos, setting *length and moving *pos past it,
+* or NULL if there is none
+*/
+static const char* nextWord(const char* doc, int* pos, int* length){
+    const char* beg;                         // beginning of word
+    const char* end;                         // end of word
+
+    // consume any non-alphabetic characters
+    while (doc[*pos] != '\0' && !isalpha(doc[*pos])) {
+        // if we find a tag, i.e., <...tag...>, skip it
+        if (doc[*pos] == '<') {
+            end = strchr(&doc[*pos], '>');          // find the close
+            if (end == NULL || *(++end) == '\0') { // ran out of html
+                return NULL;
+            }
+            *pos = end - doc;       // skip over the <...tag...>
+        } else {
+            (*pos)++;               // just move forward
+        }
+    }
+
+    // ran out of html
+    if (doc[*pos] == '\0') {
+        return NULL;
+    }
+
+    // consume word
+    beg = &(doc[*pos]);
+    while (doc[*pos] != '\0' && isalpha(doc[*pos])) {
+        (*pos)++;
+    }
+    *length = &(doc[*pos]) - beg;
+    return beg;
+}
@@ -0,0 +1,190 @@
+/*
+ * arena.c - CS50 'arena' module
+ *
+ * see arena.h for more information.
+ *
+ * The arena is a list of blocks, with the offset of the first free byte in
+ * the current block. Allocating moves the offset up, moving on to the next
+ * block, or adding one after the current block, when the current one is full.
+ * arena_alloc rounds the offset up to ALIGN first; arena_strndup does not,
+ * so strings copied one after another are packed with no gaps between them.
+ * Resetting makes the first block current again, with the offset at its start,
+ * so the blocks are reused in the same order, without freeing any of them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include "arena.h"
+#include "mem.h"
+
+/**************** file-local global variables ****************/
+static const size_t ALIGN = alignof(max_align_t);  // alignment of every allocation
+
+/**************** local types ****************/
+typedef struct block {
+  struct block* next;         // next block in the list
+  size_t size;                // bytes in the block after its header
+} block_t;
+
+/**************** global types ****************/
+typedef struct arena {
+  block_t* first;             // first block, or NULL before the first alloc
+  block_t* current;           // block being allocated from
+  size_t used;                // bytes of the current block allocated
+  size_t blockSize;           // size of a new block, unless an allocation is larger
+} arena_t;
+
+/**************** local functions ****************/
+/* not visible outside this file */
+static size_t roundUp(const size_t size);
+static char* blockData(block_t* block);
+static block_t* block_new(const size_t size);
+static char* take(arena_t* arena, const size_t size, const bool aligned);
+
+/**************** arena_new() ****************/
+/* see arena.h for description */
+arena_t*
+arena_new(const size_t blockSize)
+{
+  if (blockSize == 0) {
+    return NULL;
+  }
+
+  arena_t* arena = mem_malloc(sizeof(arena_t));
+  if (arena == NULL) {
+    return NULL;              // error allocating arena
+  }
+  arena->first = NULL;
+  arena->current = NULL;
+  arena->used = 0;
+  arena->blockSize = roundUp(blockSize);
+  return arena;
+}
+
+/**************** arena_alloc() ****************/
+/* see arena.h for description */
+void*
+arena_alloc(arena_t* arena, const size_t size)
+{
+  if (arena == NULL) {
+    return NULL;
+  }
+  return take(arena, roundUp(size > 0 ? size : 1), true);
+}
+
+/**************** arena_strndup() ****************/
+/* see arena.h for description */
+char*
+arena_strndup(arena_t* arena, const char* str, const size_t n)
+{
+  if (arena == NULL || str == NULL) {
+    return NULL;
+  }
+
+  const char* end = memchr(str, '\0', n);
+  size_t len = end == NULL ? n : (size_t)(end - str);
+  char* copy = take(arena, len + 1, false);
+  if (copy != NULL) {
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+  }
+  return copy;
+}
+
+/**************** arena_reset() ****************/
+/* see arena.h for description */
+void
+arena_reset(arena_t* arena)
+{
+  if (arena != NULL) {
+    arena->current = NULL;    // the next alloc starts over at the first block
+    arena->used = 0;
+  }
+}
+
+/**************** arena_delete() ****************/
+/* see arena.h for description */
+void
+arena_delete(arena_t* arena)
+{
+  if (arena != NULL) {
+    block_t* block = arena->first;
+    while (block != NULL) {
+      block_t* next = block->next;
+      mem_free(block);
+      block = next;
+    }
+    mem_free(arena);
+  }
+
+#ifdef MEMTEST
+  mem_report(stdout, "End of arena_delete");
+#endif
+}
+
+/**************** roundUp ****************/
+/* Return size rounded up to a multiple of ALIGN. */
+static size_t
+roundUp(const size_t size)
+{
+  return (size + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+/**************** blockData ****************/
+/* Return the first byte of the block after its header, aligned like the block. */
+static char*
+blockData(block_t* block)
+{
+  return (char*)block + roundUp(sizeof(block_t));
+}
+
+/**************** block_new ****************/
+/* Allocate a block of size bytes after its header, or return NULL if out of memory. */
+static block_t*
+block_new(const size_t size)
+{
+  block_t* block = mem_malloc(roundUp(sizeof(block_t)) + size);
+  if (block != NULL) {
+    block->next = NULL;
+    block->size = size;
+  }
+  return block;
+}
+
+/**************** take ****************/
+/* Return size bytes from the arena, at an offset rounded up to ALIGN if aligned,
+ * moving on to the next block, or adding one, if the current block is full;
+ * or return NULL if out of memory.
+ */
+static char*
+take(arena_t* arena, const size_t size, const bool aligned)
+{
+  size_t start = aligned ? roundUp(arena->used) : arena->used;
+
+  // move on to the next block, adding one if there is none big enough
+  if (arena->current == NULL || start + size > arena->current->size) {
+    block_t* next = arena->current == NULL ? arena->first : arena->current->next;
+    if (next == NULL || next->size < size) {
+      block_t* block = block_new(size > arena->blockSize ? roundUp(size) : arena->blockSize);
+      if (block == NULL) {
+        return NULL;
+      }
+      block->next = next;
+      if (arena->current == NULL) {
+        arena->first = block;
+      } else {
+        arena->current->next = block;
+      }
+      next = block;
+    }
+    arena->current = next;
+    start = 0;
+  }
+
+  arena->used = start + size;
+  return blockData(arena->current) + start;
+}
@@ -0,0 +1,89 @@
+/* 
+ * arena.h - header file for CS50 arena module
+ *
+ * An *arena* is a region of memory for short-lived allocations that are all
+ * released together: allocating takes a few bytes off the end of a block,
+ * and nothing is freed on its own. Resetting the arena releases everything
+ * allocated from it at once, in constant time, keeping its blocks to be reused;
+ * so scratch memory for each page of a crawl or an index comes from the same
+ * few blocks, rather than from malloc and free for each string.
+ *
+ * Memory allocated from an arena is aligned for any type, except strings
+ * copied by arena_strndup, which are packed one after another; all of it
+ * stays valid until the arena is reset or deleted. An arena is not safe to share between
+ * threads; give each thread its own.
+ */
+
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include <stdio.h>
+
+/**************** global types ****************/
+typedef struct arena arena_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** arena_new ****************/
+/* Create a new (empty) arena.
+ *
+ * Caller provides:
+ *   size of the blocks to allocate from, in bytes (must be > 0);
+ *   an allocation larger than that gets a block of its own.
+ * We return:
+ *   pointer to a new arena, or NULL if error.
+ * We guarantee:
+ *   no block is allocated until the first arena_alloc.
+ * Caller is responsible for:
+ *   later calling arena_delete.
+ */
+arena_t* arena_new(const size_t blockSize);
+
+/**************** arena_alloc ****************/
+/* Allocate size bytes from the arena.
+ *
+ * Caller provides:
+ *   valid arena, and the number of bytes wanted.
+ * We return:
+ *   pointer to size bytes, aligned for any type and not initialized;
+ *   NULL if arena is NULL or out of memory.
+ * Notes:
+ *   the memory must not be freed; it is released by arena_reset or arena_delete.
+ */
+void* arena_alloc(arena_t* arena, const size_t size);
+
+/**************** arena_strndup ****************/
+/* Copy a string, or its first n chars, into the arena.
+ *
+ * Caller provides:
+ *   valid arena, string to copy, and the most chars to copy.
+ * We return:
+ *   pointer to a null-terminated copy of the first n chars of str, or all of it
+ *   if it is shorter; NULL if arena or str is NULL, or out of memory.
+ * Notes:
+ *   the copy is not aligned; it starts right after the previous string copied,
+ *   if that fits in the same block.
+ */
+char* arena_strndup(arena_t* arena, const char* str, const size_t n);
+
+/**************** arena_reset ****************/
+/* Release everything allocated from the arena, in constant time.
+ *
+ * Caller provides:
+ *   arena (may be NULL).
+ * We guarantee:
+ *   the arena keeps its blocks, and allocates from them again.
+ * Notes:
+ *   memory allocated from the arena before the reset must no longer be used.
+ */
+void arena_reset(arena_t* arena);
+
+/**************** arena_delete ****************/
+/* Delete the arena, and everything allocated from it.
+ *
+ * Caller provides:
+ *   arena (may be NULL).
+ */
+void arena_delete(arena_t* arena);
+
+#endif // __ARENA_H
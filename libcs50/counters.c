@@ -0,0 +1,263 @@
+/*
+ * counters.c - CS50 'counters' module
+ *
+ * see counters.h for more information.
+ *
+ * The counters are kept in an array sorted by key, which grows by
+ * doubling, so finding a key is a binary search, and iterating walks
+ * the keys in increasing order. Adding a key larger than any yet in the
+ * set, as the indexer does when it visits documents in docID order,
+ * appends to the array without searching.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "counters.h"
+#include "mem.h"
+
+/**************** file-local global variables ****************/
+static const int MINSIZE = 4;   // counters in the first array allocated
+
+/**************** local types ****************/
+typedef struct counter {
+  int key;                    // the key
+  int count;                  // its counter
+} counter_t;
+
+/**************** global types ****************/
+typedef struct counters {
+  counter_t* array;           // counters, sorted by key
+  int num;                    // counters in use
+  int size;                   // counters allocated
+} counters_t;
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+/* see counters.h for comments about exported functions */
+
+/**************** local functions ****************/
+/* not visible outside this file */
+static int counters_search(counters_t* ctrs, const int key);
+static bool counters_insert(counters_t* ctrs, const int pos, const int key, const int count);
+static bool counters_reserve(counters_t* ctrs, const int num);
+
+/**************** counters_new() ****************/
+/* see counters.h for description */
+counters_t*
+counters_new(void)
+{
+  counters_t* ctrs = mem_malloc(sizeof(counters_t));
+
+  if (ctrs == NULL) {
+    return NULL;              // error allocating counters
+  } else {
+    // initialize contents of counters structure
+    ctrs->array = NULL;
+    ctrs->num = 0;
+    ctrs->size = 0;
+    return ctrs;
+  }
+}
+
+/**************** counters_add() ****************/
+/* see counters.h for description */
+int
+counters_add(counters_t* ctrs, const int key)
+{
+  if (ctrs == NULL || key < 0) {
+    return 0;
+  }
+
+  // the key is usually the largest so far, or the same as the last added
+  int pos = ctrs->num;
+  if (pos > 0 && ctrs->array[pos-1].key >= key) {
+    pos = counters_search(ctrs, key);
+  }
+  if (pos < ctrs->num && ctrs->array[pos].key == key) {
+    return ++ctrs->array[pos].count;
+  }
+  return counters_insert(ctrs, pos, key, 1) ? 1 : 0;
+}
+
+/**************** counters_get() ****************/
+/* see counters.h for description */
+int
+counters_get(counters_t* ctrs, const int key)
+{
+  if (ctrs == NULL || key < 0) {
+    return 0;
+  }
+
+  int pos = counters_search(ctrs, key);
+  if (pos < ctrs->num && ctrs->array[pos].key == key) {
+    return ctrs->array[pos].count;
+  }
+  return 0;
+}
+
+/**************** counters_set() ****************/
+/* see counters.h for description */
+bool
+counters_set(counters_t* ctrs, const int key, const int count)
+{
+  if (ctrs == NULL || key < 0 || count < 0) {
+    return false;
+  }
+
+  int pos = ctrs->num;
+  if (pos > 0 && ctrs->array[pos-1].key >= key) {
+    pos = counters_search(ctrs, key);
+  }
+  if (pos < ctrs->num && ctrs->array[pos].key == key) {
+    ctrs->array[pos].count = count;
+    return true;
+  }
+  return counters_insert(ctrs, pos, key, count);
+}
+
+/**************** counters_merge() ****************/
+/* see counters.h for description */
+bool
+counters_merge(counters_t* dest, counters_t* src)
+{
+  if (dest == NULL || src == NULL) {
+    return false;
+  }
+  if (src->num == 0) {
+    return true;
+  }
+
+  // merge the two sorted arrays from the back, into the end of dest's array
+  if (!counters_reserve(dest, dest->num + src->num)) {
+    return false;
+  }
+  int d = dest->num - 1;                  // last unmerged counter of dest
+  int s = src->num - 1;                   // last unmerged counter of src
+  int out = dest->num + src->num - 1;     // where the next largest goes
+  while (s >= 0) {
+    if (d >= 0 && dest->array[d].key > src->array[s].key) {
+      dest->array[out--] = dest->array[d--];
+    } else if (d >= 0 && dest->array[d].key == src->array[s].key) {
+      dest->array[out] = dest->array[d--];
+      dest->array[out--].count += src->array[s--].count;
+    } else {
+      dest->array[out--] = src->array[s--];
+    }
+  }
+
+  // keys in both sets left a gap of unused counters; close it
+  int gap = out - d;
+  if (gap > 0) {
+    memmove(&dest->array[d+1], &dest->array[out+1],
+            (dest->num + src->num - 1 - out) * sizeof(counter_t));
+  }
+  dest->num += src->num - gap;
+  return true;
+}
+
+/**************** counters_print() ****************/
+/* see counters.h for description */
+void
+counters_print(counters_t* ctrs, FILE* fp)
+{
+  if (fp != NULL) {
+    if (ctrs != NULL) {
+      fputc('{', fp);
+      for (int i = 0; i < ctrs->num; i++) {
+        fprintf(fp, "%d=%d,", ctrs->array[i].key, ctrs->array[i].count);
+      }
+      fputc('}', fp);
+    } else {
+      fputs("(null)", fp);
+    }
+  }
+}
+
+/**************** counters_iterate() ****************/
+/* see counters.h for description */
+void
+counters_iterate(counters_t* ctrs, void* arg,
+                 void (*itemfunc)(void* arg, const int key, const int count))
+{
+  if (ctrs != NULL && itemfunc != NULL) {
+    // call itemfunc with arg, on each item, in order of key
+    for (int i = 0; i < ctrs->num; i++) {
+      (*itemfunc)(arg, ctrs->array[i].key, ctrs->array[i].count);
+    }
+  }
+}
+
+/**************** counters_delete() ****************/
+/* see counters.h for description */
+void
+counters_delete(counters_t* ctrs)
+{
+  if (ctrs != NULL) {
+    free(ctrs->array);        // allocated with realloc, not mem_malloc
+    mem_free(ctrs);
+  }
+
+#ifdef MEMTEST
+  mem_report(stdout, "End of counters_delete");
+#endif
+}
+
+/**************** counters_search ****************/
+/* Return the position of key in the array,
+ * or the position it would be inserted at if it is not there.
+ */
+static int
+counters_search(counters_t* ctrs, const int key)
+{
+  int low = 0;
+  int high = ctrs->num;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (ctrs->array[mid].key < key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/**************** counters_insert ****************/
+/* Insert a new counter for key at pos, shifting the later counters up. */
+static bool
+counters_insert(counters_t* ctrs, const int pos, const int key, const int count)
+{
+  if (!counters_reserve(ctrs, ctrs->num + 1)) {
+    return false;
+  }
+  memmove(&ctrs->array[pos+1], &ctrs->array[pos], (ctrs->num - pos) * sizeof(counter_t));
+  ctrs->array[pos].key = key;
+  ctrs->array[pos].count = count;
+  ctrs->num++;
+  return true;
+}
+
+/**************** counters_reserve ****************/
+/* Make room in the array for at least num counters, at least doubling it if it must grow. */
+static bool
+counters_reserve(counters_t* ctrs, const int num)
+{
+  if (num <= ctrs->size) {
+    return true;
+  }
+  int size = ctrs->size * 2;
+  if (size < MINSIZE) {
+    size = MINSIZE;
+  }
+  if (size < num) {
+    size = num;
+  }
+  counter_t* array = realloc(ctrs->array, size * sizeof(counter_t));
+  if (array == NULL) {
+    return false;
+  }
+  ctrs->array = array;
+  ctrs->size = size;
+  return true;
+}
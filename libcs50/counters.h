@@ -82,6 +82,21 @@ int counters_get(counters_t* ctrs, const int key);
  */
 bool counters_set(counters_t* ctrs, const int key, const int count);
 
+/**************** counters_merge ****************/
+/* Add every counter of src to the counter for the same key in dest.
+ *
+ * Caller provides:
+ *   valid pointers to two countersets.
+ * We return:
+ *   false if dest or src is NULL, or if out of memory; otherwise true.
+ * We do:
+ *   for each key in src, add its counter to dest's counter for that key,
+ *   creating it if dest has none, in one pass over both countersets.
+ * Note:
+ *   src is unchanged as a result of this call.
+ */
+bool counters_merge(counters_t* dest, counters_t* src);
+
 /**************** counters_print ****************/
 /* Print all counters; provide the output file.
  *
@@ -106,8 +121,9 @@ void counters_print(counters_t* ctrs, FILE* fp);
  *   nothing, if ctrs==NULL or itemfunc==NULL.
  *   otherwise, call itemfunc once for each item, with (arg, key, count).
  * Note:
- *   the order in which items are handled is undefined.
- *   the counterset is unchanged by this operation.
+ *   items are handled in increasing order of key.
+ *   the counterset is unchanged by this operation,
+ *   and itemfunc must not add keys to it (it may set existing ones).
  */
 void counters_iterate(counters_t* ctrs, void* arg, 
                       void (*itemfunc)(void* arg, 
@@ -4,13 +4,29 @@
  * See file.h for documentation.
  * 
  * David Kotz - 2016, 2017, 2019, 2021
+ *
+ * Buffers grow geometrically, and lines and whole files are read a block
+ * at a time, so reading an N-byte line or file costs O(N) time and
+ * O(log N) reallocs.
  */
 
+/* getline, getc_unlocked, and fileno are POSIX, not C11 */
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <ctype.h>
+#include <stdbool.h>
+#include <sys/stat.h>
 #include "file.h"
 
+/**************** local constants ****************/
+static const size_t BLOCK = 65536;  // bytes per fread when reading a whole file
+static const size_t START = 81;     // initial buffer, big enough for "typical" words/lines
+
+/**************** local functions ****************/
+static char* grow(char* buf, size_t* size, const size_t need);
 
 /**************** file_numLines ****************/
 int
@@ -22,10 +38,12 @@ file_numLines(FILE* fp)
 
   rewind(fp);
 
+  // read the file a block at a time, and count newlines with memchr
   int nlines = 0;
-  char c = '\0';
-  while ( (c = fgetc(fp)) != EOF) {
-    if (c == '\n') {
+  char buf[BUFSIZ];
+  size_t n;
+  while ( (n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+    for (char* p = buf; (p = memchr(p, '\n', buf + n - p)) != NULL; p++) {
       nlines++;
     }
   }
@@ -38,20 +56,106 @@ file_numLines(FILE* fp)
 /**************** utility stopfuncs ****************/
 // for use with readuntil()
 static int never(int c) { return (0); }
-static int isnewline(int c) { return (c == '\n'); }
 
 /**************** file_readFile ****************/
 /* See file.h for documentation. */
-char* file_readFile(FILE* fp) { return file_readUntil(fp, never); }
+char* file_readFile(FILE* fp) { return file_readFileLen(fp, NULL); }
 
 /**************** file_readLine ****************/
 /* See file.h for documentation. */
-char* file_readLine(FILE* fp) { return file_readUntil(fp, isnewline); }
+char* file_readLine(FILE* fp) { return file_readLineLen(fp, NULL); }
 
 /**************** readword ****************/
 /* See file.h for documentation. */
 char* file_readWord(FILE* fp) { return file_readUntil(fp, isspace); }
 
+/**************** file_readFileLen ****************/
+/* See file.h for documentation. */
+char*
+file_readFileLen(FILE* fp, size_t* lenp)
+{
+  if (fp == NULL) {
+    return NULL;
+  }
+
+  // if fp is a regular file, we know how much remains, and can allocate
+  // it all at once; otherwise start with one block and keep doubling.
+  size_t size = BLOCK;
+  struct stat st;
+  long here = ftell(fp);
+  if (here >= 0 && fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode)
+      && st.st_size > here) {
+    size = st.st_size - here + 1;
+  }
+  char* buf = malloc(size);
+  if (buf == NULL) {
+    return NULL;
+  }
+
+  // read until a read comes back short, at EOF, always keeping room for the
+  // terminating null; when the buffer fills, grow it only if a probe for
+  // one more char shows there is more to read, so a regular file read
+  // from its known size is never grown
+  size_t len = 0;
+  while (true) {
+    size_t want = size - 1 - len;
+    size_t n = fread(buf + len, 1, want, fp);
+    len += n;
+    if (n < want) {
+      break;
+    }
+    int c = getc(fp);
+    if (c == EOF) {
+      break;
+    }
+    if ((buf = grow(buf, &size, size + BLOCK)) == NULL) {
+      return NULL;
+    }
+    buf[len++] = c;
+  }
+
+  if (len == 0) {
+    // no characters were read and we reached EOF
+    free(buf);
+    return NULL;
+  }
+  buf[len] = '\0';
+  if (lenp != NULL) {
+    *lenp = len;
+  }
+  return buf;
+}
+
+/**************** file_readLineLen ****************/
+/* See file.h for documentation. */
+char*
+file_readLineLen(FILE* fp, size_t* lenp)
+{
+  if (fp == NULL) {
+    return NULL;
+  }
+
+  // getline scans stdio's buffer for the newline a block at a time,
+  // growing our buffer as needed
+  char* buf = NULL;
+  size_t size = 0;
+  ssize_t len = getline(&buf, &size, fp);
+  if (len < 0) {
+    // error, or EOF reached without reading a line
+    free(buf);
+    return NULL;
+  }
+
+  // drop the newline
+  if (len > 0 && buf[len-1] == '\n') {
+    buf[--len] = '\0';
+  }
+  if (lenp != NULL) {
+    *lenp = len;
+  }
+  return buf;
+}
+
 /**************** readuntil ****************/
 /* See file.h for documentation. */
 char* 
@@ -62,28 +166,23 @@ file_readUntil(FILE* fp, int (*stopfunc)(int c))
   }
 
   // allocate buffer big enough for "typical" words/lines
-  int len = 81;
-  char* buf = malloc(len * sizeof(char));
+  size_t size = START;
+  char* buf = malloc(size);
   if (buf == NULL) {
     return NULL;
   }
 
   // Read characters from file until stop-character or EOF, 
-  // expanding the buffer when needed to hold more.
-  int pos;
-  char c;
-  for (pos = 0; (c = fgetc(fp)) != EOF && !(*stopfunc)(c); pos++) {
+  // doubling the buffer when needed to hold more.
+  // Only we read from fp meanwhile, so we can skip stdio's per-character locking.
+  size_t pos;
+  int c;
+  for (pos = 0; (c = getc_unlocked(fp)) != EOF && !(*stopfunc)(c); pos++) {
     // We need to save buf[pos+1] for the terminating null
-    // and buf[len-1] is the last usable slot, 
+    // and buf[size-1] is the last usable slot, 
     // so if pos+1 is past that slot, we need to grow the buffer.
-    if (pos+1 > len-1) {
-      char* newbuf = realloc(buf, ++len * sizeof(char));
-      if (newbuf == NULL) {
-        free(buf);
-        return NULL;
-      } else {
-        buf = newbuf;
-      }
+    if (pos+1 > size-1 && (buf = grow(buf, &size, pos+2)) == NULL) {
+      return NULL;
     }
     buf[pos] = c;
   }
@@ -99,6 +198,27 @@ file_readUntil(FILE* fp, int (*stopfunc)(int c))
   }
 }
 
+/**************** grow ****************/
+/* Grow buf to hold at least need bytes, at least doubling its *size;
+ * update *size and return the new buffer.
+ * If out of memory, free buf and return NULL.
+ */
+static char*
+grow(char* buf, size_t* size, const size_t need)
+{
+  size_t newsize = *size * 2;
+  if (newsize < need) {
+    newsize = need;
+  }
+  char* newbuf = realloc(buf, newsize);
+  if (newbuf == NULL) {
+    free(buf);
+    return NULL;
+  }
+  *size = newsize;
+  return newbuf;
+}
+
 /* ********************************************************** */
 /* a simple unit test of the code above */
 #ifdef QUICKTEST
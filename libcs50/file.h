@@ -8,6 +8,7 @@
 #define __FILE_H
 
 #include <stdio.h>
+#include <stddef.h>
 
 /**************** file_numLines ****************/
 /* Returns the number of lines in the given file,
@@ -27,6 +28,7 @@ int file_numLines(FILE* fp);
  * The stopfunc may be NULL, in which case it is considered always 0.
  * Returns empty string if stop occurs on the first character encountered.
  * Returns NULL if error, or EOF reached without reading anything.
+ * No other thread may use fp during the call.
  */
 char* file_readUntil(FILE* fp,    int (*stopfunc)(int c) );
 
@@ -39,6 +41,14 @@ char* file_readUntil(FILE* fp,    int (*stopfunc)(int c) );
  */
 char* file_readFile(FILE* fp);
 
+/**************** file_readFileLen ****************/
+/* 
+ * Just like file_readFile, but if lenp is not NULL, also set *lenp to
+ * the length of the string returned (when it is not NULL),
+ * so the caller need not strlen it.
+ */
+char* file_readFileLen(FILE* fp, size_t* lenp);
+
 /**************** file_readLine ****************/
 /* 
  * Read a line from the file into a null-terminated string,
@@ -49,6 +59,14 @@ char* file_readFile(FILE* fp);
  */
 char* file_readLine(FILE* fp);
 
+/**************** file_readLineLen ****************/
+/* 
+ * Just like file_readLine, but if lenp is not NULL, also set *lenp to
+ * the length of the string returned (when it is not NULL),
+ * so the caller need not strlen it.
+ */
+char* file_readLineLen(FILE* fp, size_t* lenp);
+
 /**************** file_readWord ****************/
 /* 
  * Read a word from the file into a null-terminated string,
@@ -7,6 +7,8 @@
  */
 
 #include <string.h>
+#include <ctype.h>
+#include <limits.h>
 #include "hash.h" 
 
 // hash_jenkins - see header file for usage
@@ -32,3 +34,26 @@ hash_jenkins(const char* str, const unsigned long mod)
 
   return (hash % mod);
 }
+
+// hash_jenkinsLower - see header file for usage
+unsigned long
+hash_jenkinsLower(const char* str, const int length, char* lower)
+{
+  unsigned long hash = 0;
+
+  // the same steps as hash_jenkins, on each char as it is lowercased
+  for (int i = 0; i < length; i++) {
+    lower[i] = tolower((unsigned char)str[i]);
+    hash += lower[i];
+    hash += (hash << 10);
+    hash ^= (hash >> 6);
+  }
+  lower[length] = '\0';
+
+  hash += (hash << 3);
+  hash ^= (hash >> 11);
+  hash += (hash << 15);
+
+  // reduced as hash_jenkins(lower, ULONG_MAX) reduces it, so the two agree on every word
+  return (hash % ULONG_MAX);
+}
@@ -18,4 +18,15 @@
  */
 unsigned long hash_jenkins(const char* str, const unsigned long mod);
 
+/*
+ * hash_jenkinsLower - hash a word and lowercase it in one pass
+ * str: the first of length chars to hash (non-NULL; need not be null-terminated)
+ * lower: room for length+1 chars (non-NULL)
+ *
+ * Writes the lowercase of those chars into lower, with a '\0', and
+ * returns hash_jenkins(lower, ULONG_MAX), exactly, for use with
+ * strpool_internHashed, which takes that hash.
+ */
+unsigned long hash_jenkinsLower(const char* str, const int length, char* lower);
+
 #endif // HASH_H
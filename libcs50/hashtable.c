@@ -0,0 +1,241 @@
+/*
+ * hashtable.c - CS50 'hashtable' module
+ *
+ * see hashtable.h for more information.
+ *
+ * The table starts with the number of slots the caller asks for, and
+ * doubles whenever the average chain grows past MAXLOAD items, so that
+ * finding and inserting stay O(1) no matter how many items are added.
+ * Each item keeps the full hash of its key, so growing the table does
+ * not rehash any strings and a lookup only compares keys whose hashes match.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "hashtable.h"
+#include "hash.h"
+#include "mem.h"
+
+/**************** file-local global variables ****************/
+static const int MAXLOAD = 2;   // average items per slot before the table doubles
+
+/**************** local types ****************/
+typedef struct htnode {
+  char* key;                  // copy of the key string
+  void* item;                 // pointer to data for this item
+  unsigned long hash;         // full hash of key
+  struct htnode* next;        // link to next node in the same slot
+} htnode_t;
+
+/**************** global types ****************/
+typedef struct hashtable {
+  htnode_t** table;           // array of slots, each a list of nodes
+  int num_slots;              // number of slots in table
+  int num_items;              // number of nodes in all slots
+} hashtable_t;
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+/* see hashtable.h for comments about exported functions */
+
+/**************** local functions ****************/
+/* not visible outside this file */
+static htnode_t* htnode_find(hashtable_t* ht, const char* key, const unsigned long hash);
+static void grow(hashtable_t* ht);
+
+/**************** hashtable_new() ****************/
+/* see hashtable.h for description */
+hashtable_t*
+hashtable_new(const int num_slots)
+{
+  if (num_slots <= 0) {
+    return NULL;
+  }
+
+  hashtable_t* ht = mem_malloc(sizeof(hashtable_t));
+  if (ht == NULL) {
+    return NULL;              // error allocating hashtable
+  }
+
+  ht->table = mem_calloc(num_slots, sizeof(htnode_t*));
+  if (ht->table == NULL) {
+    mem_free(ht);
+    return NULL;              // error allocating slots
+  }
+  ht->num_slots = num_slots;
+  ht->num_items = 0;
+  return ht;
+}
+
+/**************** hashtable_insert() ****************/
+/* see hashtable.h for description */
+bool
+hashtable_insert(hashtable_t* ht, const char* key, void* item)
+{
+  if (ht == NULL || key == NULL || item == NULL) {
+    return false;
+  }
+
+  const unsigned long hash = hash_jenkins(key, ULONG_MAX);
+  if (htnode_find(ht, key, hash) != NULL) {
+    return false;             // key already exists
+  }
+
+  // allocate a new node, with its own copy of the key
+  htnode_t* node = mem_malloc(sizeof(htnode_t));
+  if (node == NULL) {
+    return false;
+  }
+  size_t len = strlen(key) + 1;
+  node->key = mem_malloc(len);
+  if (node->key == NULL) {
+    mem_free(node);
+    return false;
+  }
+  memcpy(node->key, key, len);
+  node->item = item;
+  node->hash = hash;
+
+  // add it to the head of its slot
+  int slot = hash % ht->num_slots;
+  node->next = ht->table[slot];
+  ht->table[slot] = node;
+  ht->num_items++;
+
+  if (ht->num_items > ht->num_slots * MAXLOAD) {
+    grow(ht);
+  }
+  return true;
+}
+
+/**************** hashtable_find() ****************/
+/* see hashtable.h for description */
+void*
+hashtable_find(hashtable_t* ht, const char* key)
+{
+  if (ht == NULL || key == NULL) {
+    return NULL;
+  }
+
+  htnode_t* node = htnode_find(ht, key, hash_jenkins(key, ULONG_MAX));
+  return node == NULL ? NULL : node->item;
+}
+
+/**************** hashtable_print() ****************/
+/* see hashtable.h for description */
+void
+hashtable_print(hashtable_t* ht, FILE* fp,
+                void (*itemprint)(FILE* fp, const char* key, void* item))
+{
+  if (fp == NULL) {
+    return;
+  }
+  if (ht == NULL) {
+    fputs("(null)\n", fp);
+    return;
+  }
+
+  for (int slot = 0; slot < ht->num_slots; slot++) {
+    fprintf(fp, "%4d: ", slot);
+    if (itemprint != NULL) {
+      fputc('{', fp);
+      for (htnode_t* node = ht->table[slot]; node != NULL; node = node->next) {
+        (*itemprint)(fp, node->key, node->item);
+        if (node->next != NULL) {
+          fputc(',', fp);
+        }
+      }
+      fputc('}', fp);
+    }
+    fputc('\n', fp);
+  }
+}
+
+/**************** hashtable_iterate() ****************/
+/* see hashtable.h for description */
+void
+hashtable_iterate(hashtable_t* ht, void* arg,
+                  void (*itemfunc)(void* arg, const char* key, void* item) )
+{
+  if (ht != NULL && itemfunc != NULL) {
+    for (int slot = 0; slot < ht->num_slots; slot++) {
+      for (htnode_t* node = ht->table[slot]; node != NULL; node = node->next) {
+        (*itemfunc)(arg, node->key, node->item);
+      }
+    }
+  }
+}
+
+/**************** hashtable_delete() ****************/
+/* see hashtable.h for description */
+void
+hashtable_delete(hashtable_t* ht, void (*itemdelete)(void* item) )
+{
+  if (ht != NULL) {
+    for (int slot = 0; slot < ht->num_slots; slot++) {
+      htnode_t* node = ht->table[slot];
+      while (node != NULL) {
+        htnode_t* next = node->next;
+        if (itemdelete != NULL) {
+          (*itemdelete)(node->item);
+        }
+        mem_free(node->key);
+        mem_free(node);
+        node = next;
+      }
+    }
+    mem_free(ht->table);
+    mem_free(ht);
+  }
+
+#ifdef MEMTEST
+  mem_report(stdout, "End of hashtable_delete");
+#endif
+}
+
+/**************** htnode_find ****************/
+/* Return the node for key, whose full hash is given, or NULL if not found. */
+static htnode_t*
+htnode_find(hashtable_t* ht, const char* key, const unsigned long hash)
+{
+  for (htnode_t* node = ht->table[hash % ht->num_slots]; node != NULL; node = node->next) {
+    if (node->hash == hash && strcmp(node->key, key) == 0) {
+      return node;
+    }
+  }
+  return NULL;
+}
+
+/**************** grow ****************/
+/* Double the number of slots, moving each node to its new slot.
+ * If there is no memory for more slots, keep the table as it is;
+ * it still works, with longer chains.
+ */
+static void
+grow(hashtable_t* ht)
+{
+  if (ht->num_slots > INT_MAX / 2) {
+    return;
+  }
+  int num_slots = ht->num_slots * 2;
+  htnode_t** table = mem_calloc(num_slots, sizeof(htnode_t*));
+  if (table == NULL) {
+    return;
+  }
+
+  for (int slot = 0; slot < ht->num_slots; slot++) {
+    htnode_t* node = ht->table[slot];
+    while (node != NULL) {
+      htnode_t* next = node->next;
+      int newslot = node->hash % num_slots;
+      node->next = table[newslot];
+      table[newslot] = node;
+      node = next;
+    }
+  }
+  mem_free(ht->table);
+  ht->table = table;
+  ht->num_slots = num_slots;
+}
@@ -0,0 +1,224 @@
+/*
+ * strpool.c - CS50 'strpool' module
+ *
+ * see strpool.h for more information.
+ *
+ * The strings are copied into an arena of large blocks, and found through
+ * an open-addressed table of IDs, probed linearly from the string's hash.
+ * Each ID's string and full hash are kept in arrays indexed by the ID, so a
+ * probe compares hashes held in one array before comparing any strings, and
+ * growing the table does not rehash any strings. The table has a power of
+ * two slots, at least twice as many as there is room for IDs, so it is never
+ * more than half full; both double together.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+#include "strpool.h"
+#include "arena.h"
+#include "hash.h"
+#include "mem.h"
+
+/**************** file-local global variables ****************/
+static const size_t BLOCKSIZE = 65536;  // bytes in each block of strings
+static const int EMPTY = -1;            // ID in an unused slot
+
+/**************** global types ****************/
+typedef struct strpool {
+  arena_t* arena;             // the copies of the strings
+  const char** strings;       // string of each ID
+  unsigned long* hashes;      // full hash of each ID's string
+  int numStrings;             // number of IDs given out
+  int room;                   // IDs there is room for in strings and hashes
+  int* slots;                 // ID in each slot of the table, or EMPTY
+  int numSlots;               // number of slots, a power of two
+} strpool_t;
+
+/**************** local functions ****************/
+/* not visible outside this file */
+static int* probe(strpool_t* pool, const char* str, const unsigned long hash);
+static bool grow(strpool_t* pool);
+
+/**************** strpool_new() ****************/
+/* see strpool.h for description */
+strpool_t*
+strpool_new(const int numStrings)
+{
+  if (numStrings <= 0 || numStrings > INT_MAX / 4) {
+    return NULL;
+  }
+
+  strpool_t* pool = mem_malloc(sizeof(strpool_t));
+  if (pool == NULL) {
+    return NULL;              // error allocating strpool
+  }
+  pool->numSlots = 2;
+  while (pool->numSlots < 2 * numStrings) {
+    pool->numSlots *= 2;
+  }
+  pool->room = numStrings;
+  pool->numStrings = 0;
+  pool->arena = arena_new(BLOCKSIZE);
+  pool->strings = mem_malloc(pool->room * sizeof(char*));
+  pool->hashes = mem_malloc(pool->room * sizeof(unsigned long));
+  pool->slots = mem_malloc(pool->numSlots * sizeof(int));
+  if (pool->arena == NULL || pool->strings == NULL || pool->hashes == NULL
+      || pool->slots == NULL) {
+    strpool_delete(pool);
+    return NULL;              // error allocating its parts
+  }
+  for (int slot = 0; slot < pool->numSlots; slot++) {
+    pool->slots[slot] = EMPTY;
+  }
+  return pool;
+}
+
+/**************** strpool_intern() ****************/
+/* see strpool.h for description */
+int
+strpool_intern(strpool_t* pool, const char* str)
+{
+  if (str == NULL) {
+    return -1;
+  }
+  return strpool_internHashed(pool, str, hash_jenkins(str, ULONG_MAX));
+}
+
+/**************** strpool_internHashed() ****************/
+/* see strpool.h for description */
+int
+strpool_internHashed(strpool_t* pool, const char* str, const unsigned long hash)
+{
+  if (pool == NULL || str == NULL) {
+    return -1;
+  }
+
+  int* slot = probe(pool, str, hash);
+  if (*slot != EMPTY) {
+    return *slot;             // already interned
+  }
+
+  // make room for one more ID; there are always at least twice as many slots as room
+  if (pool->numStrings == pool->room) {
+    if (!grow(pool)) {
+      return -1;
+    }
+    slot = probe(pool, str, hash);
+  }
+  const char* copy = arena_strndup(pool->arena, str, strlen(str));
+  if (copy == NULL) {
+    return -1;
+  }
+
+  int id = pool->numStrings++;
+  pool->strings[id] = copy;
+  pool->hashes[id] = hash;
+  *slot = id;
+  return id;
+}
+
+/**************** strpool_find() ****************/
+/* see strpool.h for description */
+int
+strpool_find(strpool_t* pool, const char* str)
+{
+  if (pool == NULL || str == NULL) {
+    return -1;
+  }
+  return *probe(pool, str, hash_jenkins(str, ULONG_MAX));
+}
+
+/**************** strpool_get() ****************/
+/* see strpool.h for description */
+const char*
+strpool_get(strpool_t* pool, const int id)
+{
+  if (pool == NULL || id < 0 || id >= pool->numStrings) {
+    return NULL;
+  }
+  return pool->strings[id];
+}
+
+/**************** strpool_delete() ****************/
+/* see strpool.h for description */
+void
+strpool_delete(strpool_t* pool)
+{
+  if (pool != NULL) {
+    arena_delete(pool->arena);
+    mem_free(pool->strings);
+    mem_free(pool->hashes);
+    mem_free(pool->slots);
+    mem_free(pool);
+  }
+
+#ifdef MEMTEST
+  mem_report(stdout, "End of strpool_delete");
+#endif
+}
+
+/**************** probe ****************/
+/* Return the slot holding the ID of str, whose full hash is given,
+ * or the empty slot where its ID belongs if it has none.
+ */
+static int*
+probe(strpool_t* pool, const char* str, const unsigned long hash)
+{
+  unsigned long mask = pool->numSlots - 1;
+  for (unsigned long slot = hash & mask; ; slot = (slot + 1) & mask) {
+    int id = pool->slots[slot];
+    if (id == EMPTY
+        || (pool->hashes[id] == hash && strcmp(pool->strings[id], str) == 0)) {
+      return &pool->slots[slot];
+    }
+  }
+}
+
+/**************** grow ****************/
+/* Double the room for IDs, and the number of slots, putting each ID in its new slot.
+ * Return false, keeping the pool as it is, if there is no memory for them.
+ */
+static bool
+grow(strpool_t* pool)
+{
+  if (pool->numSlots > INT_MAX / 2) {
+    return false;
+  }
+  int room = pool->room * 2;
+  int numSlots = pool->numSlots * 2;
+  const char** strings = mem_malloc(room * sizeof(char*));
+  unsigned long* hashes = mem_malloc(room * sizeof(unsigned long));
+  int* slots = mem_malloc(numSlots * sizeof(int));
+  if (strings == NULL || hashes == NULL || slots == NULL) {
+    mem_free(strings);
+    mem_free(hashes);
+    mem_free(slots);
+    return false;
+  }
+  memcpy(strings, pool->strings, pool->numStrings * sizeof(char*));
+  memcpy(hashes, pool->hashes, pool->numStrings * sizeof(unsigned long));
+  mem_free(pool->strings);
+  mem_free(pool->hashes);
+  pool->strings = strings;
+  pool->hashes = hashes;
+  pool->room = room;
+
+  for (int slot = 0; slot < numSlots; slot++) {
+    slots[slot] = EMPTY;
+  }
+  unsigned long mask = numSlots - 1;
+  for (int id = 0; id < pool->numStrings; id++) {
+    unsigned long slot = pool->hashes[id] & mask;
+    while (slots[slot] != EMPTY) {
+      slot = (slot + 1) & mask;
+    }
+    slots[slot] = id;
+  }
+  mem_free(pool->slots);
+  pool->slots = slots;
+  pool->numSlots = numSlots;
+  return true;
+}
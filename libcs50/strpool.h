@@ -0,0 +1,91 @@
+/* 
+ * strpool.h - header file for CS50 strpool module
+ *
+ * A *strpool* interns strings: it keeps one copy of each distinct string
+ * given to it, and gives each a *string ID*, the number of distinct strings
+ * interned before it; so the IDs are 0, 1, 2, ... in the order the strings
+ * were first interned, and never change. The copies are packed one after
+ * another into large blocks of an arena (see arena.h), rather than each
+ * malloc'd on its own, and are only freed all together by strpool_delete.
+ *
+ * A user can keep data about each string in an array indexed by its ID,
+ * rather than in a hashtable keyed by a copy of the string.
+ */
+
+#ifndef __STRPOOL_H
+#define __STRPOOL_H
+
+#include <stdio.h>
+
+/**************** global types ****************/
+typedef struct strpool strpool_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** strpool_new ****************/
+/* Create a new (empty) strpool.
+ *
+ * Caller provides:
+ *   number of strings to make room for at first (must be > 0);
+ *   the pool grows as needed to hold any number.
+ * We return:
+ *   pointer to a new strpool, or NULL if error.
+ * Caller is responsible for:
+ *   later calling strpool_delete.
+ */
+strpool_t* strpool_new(const int numStrings);
+
+/**************** strpool_intern ****************/
+/* Return the ID of a string, interning a copy of it first if it is new.
+ *
+ * Caller provides:
+ *   valid strpool, valid null-terminated string.
+ * We return:
+ *   the string's ID, from 0; -1 if any parameter is NULL, or out of memory.
+ * Notes:
+ *   a string is new iff its ID is the number of strings in the pool before the call.
+ *   The string is copied; the caller is free to re-use or deallocate it.
+ */
+int strpool_intern(strpool_t* pool, const char* str);
+
+/**************** strpool_internHashed ****************/
+/* Same as strpool_intern, given the string's full hash.
+ *
+ * Caller provides:
+ *   as for strpool_intern, and hash_jenkins(str, ULONG_MAX), or the same hash
+ *   computed some other way, such as by hash_jenkinsLower.
+ */
+int strpool_internHashed(strpool_t* pool, const char* str, const unsigned long hash);
+
+/**************** strpool_find ****************/
+/* Return the ID of a string, if it has been interned.
+ *
+ * Caller provides:
+ *   valid strpool, valid null-terminated string.
+ * We return:
+ *   the string's ID; -1 if any parameter is NULL, or the string is not in the pool.
+ * Notes:
+ *   the pool is unchanged by this operation.
+ */
+int strpool_find(strpool_t* pool, const char* str);
+
+/**************** strpool_get ****************/
+/* Return the string with the given ID.
+ *
+ * Caller provides:
+ *   valid strpool, and an ID.
+ * We return:
+ *   the pool's copy of the string, valid until strpool_delete;
+ *   NULL if pool is NULL, or no string has that ID.
+ */
+const char* strpool_get(strpool_t* pool, const int id);
+
+/**************** strpool_delete ****************/
+/* Delete the strpool, and every string in it.
+ *
+ * Caller provides:
+ *   strpool (may be NULL).
+ */
+void strpool_delete(strpool_t* pool);
+
+#endif // __STRPOOL_H
@@ -20,11 +20,23 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <errno.h>
 #include <netdb.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <pthread.h>
 #include "file.h"
 #include "webpage.h"
 #include "mem.h"
 
+/* Scan html for words 16 bytes at a time with SSE2, which every x86-64 has;
+ * elsewhere, or if compiled with -DNOSIMD, scan a byte at a time.
+ */
+#if defined(__SSE2__) && !defined(NOSIMD)
+#include <emmintrin.h>
+#define WEBPAGE_SIMD
+#endif
+
 /* ***************************************** */
 /* Private types */
 struct URL {
@@ -36,13 +48,41 @@ struct URL {
   char* fragment;             // #top
 };
 
+/* hostSlot: when we may next send a request to one host; see waitForHost.
+ * The slots form a linked list, guarded by hostLock.
+ */
+typedef struct hostSlot {
+  char* hostname;                          // host these fetches go to
+  struct timespec nextFetch;               // earliest time of the next fetch
+  struct hostSlot* next;                   // next slot in the list
+} hostSlot_t;
+
+/* hostConn: an open connection to one host, idle between fetches;
+ * see takeConnection and keepConnection.
+ * The idle connections form a linked list, guarded by connLock.
+ */
+typedef struct hostConn {
+  char* hostname;                          // host at the other end
+  int port;                                // port at the other end
+  FILE* http_fp;                           // the connection
+  struct hostConn* next;                   // next connection in the list
+} hostConn_t;
+
+/* body: a response body as we read it in; see bodyReserve and bodyRead.
+ */
+typedef struct body {
+  char* buf;                               // the bytes, null-terminated
+  size_t len;                              // number of bytes read so far
+  size_t size;                             // bytes allocated for buf
+} body_t;
+
 /* webpage_t: structure to represent a web page, and its contents.
  * The innards should not be visible to users of the webpage module.
  */
 typedef struct webpage {
   char* url;                               // url of the page
   char* html;                              // html code of the page
-  size_t html_len;                         // length of html code
+  size_t html_len;                         // length of html code, in bytes
   int depth;                               // depth of crawl
 } webpage_t;
 
@@ -50,9 +90,28 @@ typedef struct webpage {
 /* Private function prototypes */
 
 static FILE* connectToHost(const char* hostname, const int port);
+static FILE* takeConnection(const char* hostname, const int port);
+static void keepConnection(const char* hostname, const int port, FILE* http_fp);
+static char* sendRequest(FILE* http_fp, const char* hostname, const char* pathname);
+static bool readLength(FILE* http_fp, const long length, body_t* body);
+static bool readChunked(FILE* http_fp, body_t* body);
+static bool readToClose(FILE* http_fp, body_t* body);
+static bool bodyReserve(body_t* body, const size_t more);
+static bool bodyRead(body_t* body, FILE* http_fp, const size_t count);
+static void waitForHost(const char* hostname);
+static void addMilliseconds(struct timespec* time, const int ms);
 static inline bool isBlankLine(const char* line);
 static char* removeDotSegments(char* input);
-static void removeWhitespace(char* str);
+static inline bool isWhite(const char c);
+static size_t skipWhite(const char* str, size_t i);
+static size_t matchWhite(const char* str, size_t i, const char* pattern);
+static size_t scanFor(const char* str, size_t i, const size_t len, const char c, const char fold);
+static inline bool isLetter(const char c);
+static size_t scanToWord(const char* doc, size_t i, const size_t len);
+static size_t scanWord(const char* doc, size_t i, const size_t len);
+#ifdef WEBPAGE_SIMD
+static inline unsigned letterMask(const __m128i bytes);
+#endif
 static char* fixRelativeURL(char* base, char* rel, size_t len);
 static bool parseURL(const char* str, struct URL* url);
 static void freeURL(struct URL url);
@@ -68,6 +127,20 @@ static void printURL(struct URL url);
 static const int MAX_TRY = 3;    // maximum attempts to fetch
 static const int HTTP_PORT = 80; // default web server port
 
+#ifndef NOSLEEP // CS50 students: please don't turn off the sleep!
+static int politeDelay = 1000;   // milliseconds between fetches from one host
+#else
+static int politeDelay = 0;
+#endif
+static hostSlot_t* hostSlots = NULL;  // per-host fetch schedule
+static pthread_mutex_t hostLock = PTHREAD_MUTEX_INITIALIZER;
+
+static const size_t READ_BLOCK = 65536;  // bytes per fread of a body
+static const int MAX_IDLE = 16;       // most idle connections we keep open
+static hostConn_t* idleConns = NULL;  // connections kept for reuse
+static int numIdle = 0;               // number of connections in idleConns
+static pthread_mutex_t connLock = PTHREAD_MUTEX_INITIALIZER;
+
 static const char* EXTS[] = {  // valid extensions
   "html",
   "htm",     // added by DFK
@@ -91,6 +164,9 @@ char* webpage_getHTML(const webpage_t* page)  {
 char* webpage_getURL(const webpage_t* page)   { 
   return page ? page->url   : NULL; 
 }
+size_t webpage_getHTMLLength(const webpage_t* page) { 
+  return page ? page->html_len : 0; 
+}
 
 /**************** webpage_new ****************/
 /* see webpage.h for documentation */
@@ -136,10 +212,12 @@ webpage_delete(void* data)
  * Pseudocode:
  *     1. check for valid page 
  *     2. parse url into hostname, port, and filename
- *     3. open a connection to the given host
+ *     3. take an idle connection to the given host, or open a new one
  *     4. send http request
- *     5. fetch html response
- *     6. cleanup
+ *     5. read the response header, noting how the body is delimited
+ *     6. fetch html response
+ *     7. keep the connection for the next fetch, if the server allows
+ *     8. cleanup
  */
 bool 
 webpage_fetch(webpage_t* page)
@@ -158,119 +236,219 @@ webpage_fetch(webpage_t* page)
     return false;
   }
 
-  // attempt to connect to server 
+  // attempt to connect to server, send the request, and receive response
   FILE* http_fp = NULL; 
-  for (int try = 0;  http_fp == NULL && try < MAX_TRY; try++) {
-    // open connection - exit on error
-    http_fp = connectToHost(hostname, port);
+  char* httpResponse = NULL;
+  for (int try = 0;  httpResponse == NULL && try < MAX_TRY; try++) {
+    // wait our turn for this host, to lighten load on server;
+    // fetches to other hosts go ahead meanwhile
+    waitForHost(hostname);
+
+    // reuse an idle connection to this host if we have one;
+    // the server may have closed it meanwhile, so then we open a new one
+    if ((http_fp = takeConnection(hostname, port)) != NULL) {
+      if ((httpResponse = sendRequest(http_fp, hostname, pathname)) == NULL) {
+        fclose(http_fp);
+        http_fp = NULL;
+      }
+    }
 
-#ifndef NOSLEEP // CS50 students: please don't turn off the sleep!
-    sleep(1);   // sleep one second between fetches, to lighten load on server
-#endif
+    // open connection - try again on error
+    if (httpResponse == NULL && (http_fp = connectToHost(hostname, port)) != NULL) {
+      if ((httpResponse = sendRequest(http_fp, hostname, pathname)) == NULL) {
+        fclose(http_fp);
+        http_fp = NULL;
+      }
+    }
   }
 
   // failed to connect?
-  if (http_fp == NULL) {
+  if (httpResponse == NULL) {
+    free(hostname);
+    free(pathname);
     return false;
   }
 
-  // prepare and send HTTP request; receive response
-  char* httpResponse = NULL;
-  const char* httpFormat =
-    "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n";
-  if (fprintf(http_fp, httpFormat, pathname, hostname) >= 0) {
-    // ensure stdio buffer is flushed to socket
-    fflush(http_fp);
-    // read the server's response
-    httpResponse = file_readLine(http_fp);
-  }
-
-  free(hostname);
-  free(pathname);
-
   // did we succeed? check the response
   bool success = false;
-
-  if (httpResponse != NULL) {
-    // check response code to see whether we succeeded
-    int httpResponseCode = 0;
-    if (sscanf(httpResponse, "HTTP/1.1 %d", &httpResponseCode) == 1
-        && httpResponseCode == 200) {
-      // success! ignore the rest of the header, then grab the page
-      // read lines until we read a blank line or fail to read a line
-      char* line = file_readLine(http_fp);
-      while (line != NULL && !isBlankLine(line)) {
-        free(line);
-        line = file_readLine(http_fp);
+  bool keepAlive = false;     // may we reuse the connection?
+
+  // check response code to see whether we succeeded
+  int httpMinor = 0;
+  int httpResponseCode = 0;
+  if (sscanf(httpResponse, "HTTP/1.%d %d", &httpMinor, &httpResponseCode) == 2
+      && httpResponseCode == 200) {
+    // success! read the header, noting how the body is delimited:
+    // by Content-Length, by chunks, or by the server closing the connection.
+    // HTTP/1.1 keeps the connection open unless the server says otherwise.
+    long contentLength = -1;
+    bool chunked = false;
+    keepAlive = (httpMinor >= 1);
+
+    // read lines until we read a blank line or fail to read a line
+    char* line = file_readLine(http_fp);
+    while (line != NULL && !isBlankLine(line)) {
+      if (strncasecmp(line, "Content-Length:", 15) == 0) {
+        contentLength = strtol(line + 15, NULL, 10);
+      } else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0) {
+        chunked = (strcasestr(line + 18, "chunked") != NULL);
+      } else if (strncasecmp(line, "Connection:", 11) == 0) {
+        if (strcasestr(line + 11, "close") != NULL) {
+          keepAlive = false;
+        } else if (strcasestr(line + 11, "keep-alive") != NULL) {
+          keepAlive = true;
+        }
       }
-      // did we exit the loop because we read an empty line?
-      if (line != NULL) {
-        free(line); // the blank line
-
-        // then grab everything else - that should be the page content
-        char* html = file_readFile(http_fp);
-        if (html != NULL) {
-          page->html = html;
-          success = true;
-        } 
+      free(line);
+      line = file_readLine(http_fp);
+    }
+    // did we exit the loop because we read an empty line?
+    if (line != NULL) {
+      free(line); // the blank line
+
+      // then grab the body - that should be the page content
+      body_t body;
+      if (chunked) {
+        success = readChunked(http_fp, &body);
+      } else if (contentLength >= 0) {
+        success = readLength(http_fp, contentLength, &body);
+      } else {
+        // body runs to end of connection, which cannot be reused
+        success = readToClose(http_fp, &body);
+        keepAlive = false;
       }
+      if (success) {
+        // keep the length we read, so the scans need not strlen the page
+        page->html = body.buf;
+        page->html_len = body.len;
+      } 
     }
-    free(httpResponse);
   }
+  free(httpResponse);
 
-  // clean up
-  fclose(http_fp);
+  // clean up; keep the connection for the next fetch if we read exactly
+  // the whole response and the server will keep its end open
+  if (success && keepAlive) {
+    keepConnection(hostname, port, http_fp);
+  } else {
+    fclose(http_fp);
+  }
+  free(hostname);
+  free(pathname);
 
   return success;
 }
 
+/**************** webpage_setPoliteness ****************/
+/* see webpage.h for documentation */
+void
+webpage_setPoliteness(const int milliseconds)
+{
+  if (milliseconds >= 0) {
+    pthread_mutex_lock(&hostLock);
+    politeDelay = milliseconds;
+    pthread_mutex_unlock(&hostLock);
+  }
+}
+
+/**************** webpage_cleanup ****************/
+/* see webpage.h for documentation */
+void
+webpage_cleanup(void)
+{
+  pthread_mutex_lock(&connLock);
+  while (idleConns != NULL) {
+    hostConn_t* next = idleConns->next;
+    fclose(idleConns->http_fp);
+    free(idleConns->hostname);
+    free(idleConns);
+    idleConns = next;
+  }
+  numIdle = 0;
+  pthread_mutex_unlock(&connLock);
+
+  pthread_mutex_lock(&hostLock);
+  while (hostSlots != NULL) {
+    hostSlot_t* next = hostSlots->next;
+    free(hostSlots->hostname);
+    free(hostSlots);
+    hostSlots = next;
+  }
+  pthread_mutex_unlock(&hostLock);
+}
+
 /**************** webpage_getNextWord ****************/
+/* see webpage.h for usage documentation.
+ *
+ * Pseudocode:
+ *     1. find the next word with webpage_getNextWordSpan
+ *     2. create a new word buffer
+ *     3. copy the word into the new buffer
+ *     4. return pointer to the word
+ */
+char* 
+webpage_getNextWord(webpage_t* page, int* pos)
+{
+  int wordlen;                             // length of the word
+  const char* beg = webpage_getNextWordSpan(page, pos, &wordlen);
+
+  if (beg == NULL) {
+    return NULL;
+  }
+
+  // allocate space for length of new word + '\0'
+  char* word = calloc(wordlen + 1, sizeof(char));
+  if (word == NULL) {        // out of memory!
+    return NULL;
+  } else {
+    // copy the new word
+    strncpy(word, beg, wordlen);
+    return word;
+  }
+}
+
+/**************** webpage_getNextWordSpan ****************/
 /* see webpage.h for usage documentation.
  *
  * Code is courtesy of Ray Jenkins and/or Charles Palmer, 
  *   cleaned by David Kotz in April 2016, 2017; updated April 2019.
  *
  * Pseudocode:
- *     1. skip any leading non-alphabetic characters
+ *     1. skip any leading non-alphabetic characters, with scanToWord
  *     2. if we find a tag, i.e., <...tag...>, skip that tag
  *     3. save beginning of the word
- *     4. find the end, i.e., first non-alphabetic character
- *     5. create a new word buffer
- *     6. copy the word into the new buffer
- *     7. update *pos to first position past end of word
- *     8. return pointer to the word
+ *     4. find the end, i.e., first non-alphabetic character, with scanWord
+ *     5. update *pos to first position past end of word
+ *     6. return pointer to the word in the html, and its length
  * 
  * Assumptions:
  *     1. webpage has html
  *     2. don't care about opening/closing tags: ignore anything between <...>
  *     3. if the html is malformed, we don't care: match '<' with next '>'
  */
-char* 
-webpage_getNextWord(webpage_t* page, int* pos)
+const char*
+webpage_getNextWordSpan(webpage_t* page, int* pos, int* length)
 {
   // make sure we have something to search, and a place for the result
-  if (page == NULL || page->html == NULL || pos == NULL) {
+  if (page == NULL || page->html == NULL || pos == NULL || length == NULL) {
     return NULL;
   }
 
   const char* doc = page->html;            // the html document
+  const size_t len = page->html_len;       // bytes the scans may read at once
   const char* beg;                         // beginning of word
   const char* end;                         // end of word
 
-  // consume any non-alphabetic characters
-  while (doc[*pos] != '\0' && !isalpha(doc[*pos])) {
-    // if we find a tag, i.e., <...tag...>, skip it
-    if (doc[*pos] == '<') {
-      end = strchr(&doc[*pos], '>');          // find the close
-      
-      if (end == NULL || *(++end) == '\0') { // ran out of html
-        return NULL;
-      }
-
-      *pos = end - doc;       // skip over the <...tag...>
-    } else {
-      (*pos)++;               // just move forward
+  // consume any non-alphabetic characters, up to a word, a tag, or the end
+  while (*pos = scanToWord(doc, *pos, len), doc[*pos] == '<') {
+    // we found a tag, i.e., <...tag...>; skip it
+    end = strchr(&doc[*pos], '>');          // find the close
+    
+    if (end == NULL || *(++end) == '\0') { // ran out of html
+      return NULL;
     }
+
+    *pos = end - doc;       // skip over the <...tag...>
   }
 
   // ran out of html
@@ -282,31 +460,21 @@ webpage_getNextWord(webpage_t* page, int* pos)
   beg = &(doc[*pos]);
 
   // consume word
-  while (doc[*pos] != '\0' && isalpha(doc[*pos])) {
-    (*pos)++;
-  }
+  *pos = scanWord(doc, *pos, len);
 
   // at this point, doc[*pos] is the first character *after* the word.
-  // so doc[*pos-1] is the last character of the word.
-  end = &(doc[*pos-1]);
-
-  // 'beg' points to first character of the word
-  // 'end' points to last character of the word
-  int wordlen = end - beg + 1;
-
-  // allocate space for length of new word + '\0'
-  char* word = calloc(wordlen + 1, sizeof(char));
-  if (word == NULL) {        // out of memory!
-    return NULL;
-  } else {
-    // copy the new word
-    strncpy(word, beg, wordlen);
-    return word;
-  }
+  *length = &(doc[*pos]) - beg;
+  return beg;
 }
 
 /**************** webpage_getNextURL ****************/
 /* See "webpage.h" for full documentation.
+ *
+ * Links are found just as they were when this function first removed all
+ * white space from the html, but without changing the html: every search
+ * below that could have matched across white space skips it instead, with
+ * skipWhite and matchWhite, and the URL is copied without its white space.
+ * The searches for single bytes look at 16 bytes at a time, with scanFor.
  *
  * Assumptions:
  *     1. page is valid, contains html and base_url
@@ -314,16 +482,16 @@ webpage_getNextWord(webpage_t* page, int* pos)
  *
  * Pseudocode:
  *     1. check arguments
- *     2. if *pos = 0 (first call for this page): remove whitespace from html
- *     3. find hyperlink starting tags "<a" or "<A"
- *     4. find next href attribute "href="
- *     5. find next end tag ">"
- *     6. check that href comes before end tag
- *     7. deal with quoted and unquoted urls
- *     8. determine if url is absolute
- *     9. fixup relative links
- *    10. update *pos to position after the URL
- *    11. create new character buffer for result and return it
+ *     2. find hyperlink starting tags "<a" or "<A"
+ *     3. find next href attribute "href="
+ *     4. find next end tag ">"
+ *     5. check that href comes before end tag
+ *     6. deal with quoted and unquoted urls
+ *     7. determine if url is absolute
+ *     8. update *pos to position after the URL
+ *     9. copy the url, without white space
+ *    10. fixup relative links
+ *    11. return the url
  */
 char* 
 webpage_getNextURL(webpage_t* page, int* pos)
@@ -333,107 +501,113 @@ webpage_getNextURL(webpage_t* page, int* pos)
     return NULL;
   }
 
-  char* html = page->html;                 // the html document
+  const char* html = page->html;           // the html document
+  const size_t len = page->html_len;       // bytes the scans may read at once
   char* base_url = page->url;              // the base URL for this html
   int bad_link;                            // is this link ill formatted?
   int relative;                            // is this link relative?
-  char delim;                              // url delimiter: ' ', ''', '"'
-  char* lnk;                               // hyperlink tags
-  char* href;                              // href in a tag
-  char* end;                               // end of hyperlink tag or url
-  char* ptr;                               // absolute vs. relative
-  char* hash;                              // hash mark character
-
-  // condense html, makes parsing easier
-  if (*pos == 0) {
-    removeWhitespace(html);
-  }
+  char delim;                              // url delimiter: ''', '"'
+  size_t lnk;                              // hyperlink tags
+  size_t href;                             // href in a tag
+  size_t end;                              // end of hyperlink tag or url
+  size_t url;                              // first char of the url
+  const char* hash;                        // hash mark character
 
   // parse for hyperlinks
   do {
     relative = 0;                        // assume absolute link
     bad_link = 0;                        // assume valid link
 
-    // find tag "<a" or "<A""
-    lnk = strcasestr(&html[*pos], "<a");
+    // find tag "<a" or "<A"
+    lnk = scanFor(html, *pos, len, '<', 0);
+    while (html[lnk] != '\0' && !matchWhite(html, lnk, "<a")) {
+      lnk = scanFor(html, lnk + 1, len, '<', 0);
+    }
 
     // no more links on this page
-    if (!lnk) { return NULL; }
+    if (html[lnk] == '\0') { return NULL; }
 
     // find next href after hyperlink tag
-    href = strcasestr(lnk, "href=");
+    href = scanFor(html, lnk, len, 'h', 0x20);
+    while (html[href] != '\0' && !matchWhite(html, href, "href=")) {
+      href = scanFor(html, href + 1, len, 'h', 0x20);
+    }
 
     // no more links on this page
-    if (!href) { return NULL; }
+    if (html[href] == '\0') { return NULL; }
 
     // find end of hyperlink tag
-    end = strchr(lnk, '>');
+    end = scanFor(html, lnk, len, '>', 0);
 
-    // if the href we have is outside the current tag, continue
-    if (end && (end < href)) {
-      bad_link = 1; (*pos) += 2; continue;
+    // if the href we have is outside the current tag, continue;
+    // on each bad link, resume just past its '<', where this "<a" is not found again
+    if (html[end] != '\0' && end < href) {
+      bad_link = 1; *pos = lnk + 1; continue;
     }
 
     // move href to beginning of url
-    href+=5;
-
-    // something went wrong, just continue
-    if (!href) { bad_link=1; (*pos) += 2; continue; }
+    href = matchWhite(html, href, "href=");
 
     // is the url quoted?
-    if (*href == '\'' || *href == '"') {  // yes, href="url" or href='url'
-      delim = *(href++);               // remember delimiter
-      end = strchr(href, delim);       // find next of same delimiter
+    url = skipWhite(html, href);
+    if (html[url] == '\'' || html[url] == '"') {  // yes, href="url" or href='url'
+      delim = html[url];                 // remember delimiter
+      href = url + 1;
+      end = scanFor(html, href, len, delim, 0);   // find next of same delimiter
     } else {             // no, href=url
-      end = strchr(href, '>');         // hope: <a ... href=url>
-      // since we've stripped whitespace
+      end = scanFor(html, href, len, '>', 0);     // hope: <a ... href=url>
+      // since we skip white space
       // this could mangle things like:
       // <a ... href=url name=val>
     }
 
-    // if there is a # before the end of the url, exclude the #fragment
-    hash = strchr(href, '#');
-    if (hash && hash < end) {
-      end = hash;
+    // if we don't know where to end the url, continue
+    if (html[end] == '\0') {
+      bad_link = 1; *pos = lnk + 1; continue;
     }
 
-    // if we don't know where to end the url, continue
-    if (!end) {
-      bad_link = 1; (*pos) += 2; continue;
+    // if there is a # before the end of the url, exclude the #fragment
+    hash = memchr(&html[href], '#', end - href);
+    if (hash) {
+      end = hash - html;
     }
 
     // have a link now
-    if (*href == '#') {                   // internal reference
-      bad_link = 1; (*pos) += 2; continue;
+    if (html[skipWhite(html, href)] == '#') {  // internal reference
+      bad_link = 1; *pos = lnk + 1; continue;
     }
 
     // is the url absolute, i.e, ':' must precede any '/', '?', or '#'
-    ptr = strpbrk(href, ":/?#");
-    if (!ptr || *ptr != ':') { 
+    if (html[href + strcspn(&html[href], ":/?#")] != ':') { 
       relative = 1; 
-    } else if (strncasecmp(href, "http", 4)) { // absolute, but not http(s)
-      bad_link = 1; (*pos) += 2; continue;
+    } else if (!matchWhite(html, skipWhite(html, href), "http")) { // absolute, but not http(s)
+      bad_link = 1; *pos = lnk + 1; continue;
     }
   } while (bad_link);                       // keep parsing
 
   // update position after the end of the url
-  *pos = end - html;
+  *pos = end;
+
+  // copy the url, without white space
+  char* result = calloc(end - href + 1, sizeof(char));
+  if (result == NULL) {
+    // out of memory
+    return NULL;
+  }
+  size_t result_len = 0;                    // chars of the url copied
+  for (size_t i = href; i < end; i++) {
+    if (!isWhite(html[i])) {
+      result[result_len++] = html[i];
+    }
+  }
 
   // have a good link now
   if (relative) {                           // need to fixup relative links
-    char* result = fixRelativeURL(base_url, href, end - href);
-    return result; // may be NULL if Fixup failed.
+    char* abs_url = fixRelativeURL(base_url, result, result_len);
+    free(result);
+    return abs_url; // may be NULL if Fixup failed.
   } else {
-    // create new buffer
-    char* result = calloc(end-href+1, sizeof(char));
-    if (result == NULL) {
-      // out of memory
-      return NULL;
-    } else {
-      // copy over absolute url
-      strncpy(result, href, end - href);
-      return result;
-    }
+    return result;
   }
 }
 
@@ -846,21 +1020,29 @@ burstURL(const char* url, char** hostname, int* port, char** pathname)
 /* Connect to the given hostname and port, 
  * returning an open FILE* for the socket,
  * or NULL on failure.
+ *
+ * We use getaddrinfo rather than gethostbyname, because the latter
+ * returns a pointer to static storage and so is unsafe to call from
+ * several threads at once (see the crawler's -j option).
  */
 static FILE* 
 connectToHost(const char* hostname, const int port)
 {
   // Look up the hostname specified on command line
-  struct hostent *hostp = gethostbyname(hostname);
-  if (hostp == NULL) {
+  struct addrinfo hints;      // what kind of address we want
+  struct addrinfo* result;    // list of addresses for hostname
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(hostname, NULL, &hints, &result) != 0) {
     return NULL;
   }
 
   // Initialize fields of the server address
   struct sockaddr_in server;  // address of the server
-  server.sin_family = AF_INET;
-  bcopy(hostp->h_addr_list[0], &server.sin_addr, hostp->h_length);
+  memcpy(&server, result->ai_addr, sizeof(server));
   server.sin_port = htons(port);
+  freeaddrinfo(result);
 
   // Create socket (a file descriptor)
   int comm_sock = socket(AF_INET, SOCK_STREAM, 0);
@@ -870,12 +1052,15 @@ connectToHost(const char* hostname, const int port)
 
   // And connect that socket to that server   
   if (connect(comm_sock, (struct sockaddr *) &server, sizeof(server)) < 0) {
+    close(comm_sock);
     return NULL;
   }
 
-  // to make it easier to work with, switch to stdio
-  FILE* http_fp = fdopen(comm_sock, "r+");
+  // to make it easier to read the response, switch to stdio;
+  // requests are written straight to the socket, see sendRequest
+  FILE* http_fp = fdopen(comm_sock, "r");
   if (http_fp == NULL) {
+    close(comm_sock);
     return NULL;
   }
 
@@ -883,6 +1068,311 @@ connectToHost(const char* hostname, const int port)
 }
 
 
+/* ********************* takeConnection ************************** */
+/* Take an idle connection to the given hostname and port out of the pool,
+ * returning its FILE*, or NULL if we have none.
+ * The caller owns the connection until it hands it back to keepConnection.
+ */
+static FILE*
+takeConnection(const char* hostname, const int port)
+{
+  FILE* http_fp = NULL;       // the connection, if any
+  hostConn_t** prev;          // link to the connection we look at
+
+  pthread_mutex_lock(&connLock);
+  for (prev = &idleConns; *prev != NULL; prev = &(*prev)->next) {
+    hostConn_t* conn = *prev;
+    if (conn->port == port && strcmp(conn->hostname, hostname) == 0) {
+      *prev = conn->next;
+      numIdle--;
+      http_fp = conn->http_fp;
+      free(conn->hostname);
+      free(conn);
+      break;
+    }
+  }
+  pthread_mutex_unlock(&connLock);
+
+  return http_fp;
+}
+
+/* ********************* keepConnection ************************** */
+/* Put a connection to the given hostname and port into the pool,
+ * for a later fetch to reuse; the pool now owns http_fp.
+ * If the pool is full, or out of memory, we just close the connection.
+ */
+static void
+keepConnection(const char* hostname, const int port, FILE* http_fp)
+{
+  hostConn_t* conn = malloc(sizeof(hostConn_t));
+  if (conn == NULL || (conn->hostname = strdup(hostname)) == NULL) {
+    free(conn);
+    fclose(http_fp);
+    return;
+  }
+  conn->port = port;
+  conn->http_fp = http_fp;
+
+  pthread_mutex_lock(&connLock);
+  if (numIdle < MAX_IDLE) {
+    conn->next = idleConns;
+    idleConns = conn;
+    numIdle++;
+    conn = NULL;
+  }
+  pthread_mutex_unlock(&connLock);
+
+  // pool is full
+  if (conn != NULL) {
+    fclose(conn->http_fp);
+    free(conn->hostname);
+    free(conn);
+  }
+}
+
+/* ********************* sendRequest ************************** */
+/* Send a GET request for pathname over the connection, and read the
+ * status line of the response; return that line (caller must free it),
+ * or NULL if the request could not be sent or no response came back,
+ * e.g., because the server closed an idle connection.
+ *
+ * We write straight to the socket, with MSG_NOSIGNAL so that writing to
+ * a connection the server has closed fails rather than raising SIGPIPE.
+ */
+static char*
+sendRequest(FILE* http_fp, const char* hostname, const char* pathname)
+{
+  const char* httpFormat =
+    "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: keep-alive\r\n\r\n";
+  size_t size = strlen(httpFormat) + strlen(pathname) + strlen(hostname) + 1;
+  char* request = malloc(size);
+  if (request == NULL) {
+    return NULL;
+  }
+
+  // prepare and send HTTP request; receive response
+  char* httpResponse = NULL;
+  int len = snprintf(request, size, httpFormat, pathname, hostname);
+  if (send(fileno(http_fp), request, len, MSG_NOSIGNAL) == len) {
+    httpResponse = file_readLine(http_fp);
+  }
+  free(request);
+
+  return httpResponse;
+}
+
+/* ********************* readLength ************************** */
+/* Read a response body of exactly length bytes into *body, whose buf
+ * is then a new null-terminated string (caller must free it) of
+ * body->len bytes; return false if the connection ends early or we
+ * are out of memory.
+ * We know the size up front, so this is one allocation and one fread.
+ */
+static bool
+readLength(FILE* http_fp, const long length, body_t* body)
+{
+  *body = (body_t){ NULL, 0, 0 };
+  if (!bodyRead(body, http_fp, length) || body->len != length) {
+    free(body->buf);
+    return false;
+  }
+  return true;
+}
+
+/* ********************* readChunked ************************** */
+/* Read a response body in chunked transfer encoding (RFC 7230 4.1)
+ * into *body, as readLength does; return false if the chunks are
+ * malformed, the connection ends early, or we are out of memory.
+ * Each chunk is its size in hex on a line of its own,
+ * then that many bytes and CRLF; a chunk of size zero ends the body,
+ * followed by optional trailer lines and a blank line.
+ */
+static bool
+readChunked(FILE* http_fp, body_t* body)
+{
+  *body = (body_t){ NULL, 0, 0 };   // the body so far
+
+  char* line;
+  while ((line = file_readLine(http_fp)) != NULL) {
+    char* end;
+    long size = strtol(line, &end, 16);
+    bool valid = (end != line && size >= 0);
+    free(line);
+    if (!valid) {
+      break;
+    }
+
+    if (size == 0) {
+      // last chunk; skip any trailers up to the blank line
+      while ((line = file_readLine(http_fp)) != NULL && !isBlankLine(line)) {
+        free(line);
+      }
+      if (line == NULL) {
+        break;
+      }
+      free(line);
+      if (body->buf == NULL && !bodyReserve(body, 0)) {
+        break;
+      }
+      return true;
+    }
+
+    // read this chunk onto the end of the body, then its CRLF
+    size_t before = body->len;
+    if (!bodyRead(body, http_fp, size) || body->len - before != size) {
+      break;
+    }
+    if ((line = file_readLine(http_fp)) == NULL) {
+      break;
+    }
+    free(line);
+  }
+
+  // malformed, short, or out of memory
+  free(body->buf);
+  return false;
+}
+
+/* ********************* readToClose ************************** */
+/* Read a response body that runs until the server closes the connection
+ * into *body, as readLength does; return false if we read nothing or
+ * are out of memory.
+ * We don't know the size, so we read in blocks of READ_BLOCK bytes.
+ */
+static bool
+readToClose(FILE* http_fp, body_t* body)
+{
+  *body = (body_t){ NULL, 0, 0 };
+  while (bodyRead(body, http_fp, READ_BLOCK) && !feof(http_fp) && !ferror(http_fp)) {
+    ;
+  }
+  if (body->len == 0 || ferror(http_fp)) {
+    free(body->buf);
+    return false;
+  }
+  return true;
+}
+
+/* ********************* bodyReserve ************************** */
+/* Make room for more bytes, plus a terminating null, at the end of body.
+ * The buffer at least doubles each time it grows, so reading a body
+ * in many pieces costs only a handful of reallocs and linear copying.
+ * Return false if out of memory (body is unchanged).
+ */
+static bool
+bodyReserve(body_t* body, const size_t more)
+{
+  size_t need = body->len + more + 1;     // bytes we need, with the null
+  if (need <= body->size) {
+    return true;
+  }
+
+  size_t size = body->size * 2;
+  if (size < need) {
+    size = need;
+  }
+  char* buf = realloc(body->buf, size);
+  if (buf == NULL) {
+    return false;
+  }
+  body->buf = buf;
+  body->size = size;
+  body->buf[body->len] = '\0';
+  return true;
+}
+
+/* ********************* bodyRead ************************** */
+/* Read up to count bytes from http_fp onto the end of body with one
+ * fread, keeping body null-terminated; fewer bytes arrive only at end of
+ * file or error, which the caller can check with body->len.
+ * Return false if out of memory.
+ */
+static bool
+bodyRead(body_t* body, FILE* http_fp, const size_t count)
+{
+  if (!bodyReserve(body, count)) {
+    return false;
+  }
+  body->len += fread(body->buf + body->len, 1, count, http_fp);
+  body->buf[body->len] = '\0';
+  return true;
+}
+
+/* ********************* waitForHost ************************** */
+/* Block until we may send the next request to the given host.
+ *
+ * Each host has a slot holding the earliest time of its next fetch.
+ * We claim the slot's current time for ourselves and push it politeDelay
+ * milliseconds later for whoever comes next, then sleep (without the lock)
+ * until our time arrives.  So fetches to one host are spaced politeDelay
+ * apart, even from several threads, while fetches to other hosts do not
+ * wait at all.  If we cannot allocate a slot, we fall back to waiting the
+ * full delay.
+ */
+static void
+waitForHost(const char* hostname)
+{
+  struct timespec now;        // current time
+  struct timespec start;      // when we may fetch
+  hostSlot_t* slot;           // schedule for hostname
+
+  pthread_mutex_lock(&hostLock);
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  start = now;
+
+  // find the slot for this host, or make one
+  for (slot = hostSlots; slot != NULL; slot = slot->next) {
+    if (strcmp(slot->hostname, hostname) == 0) {
+      break;
+    }
+  }
+  if (slot == NULL && (slot = malloc(sizeof(hostSlot_t))) != NULL) {
+    if ((slot->hostname = strdup(hostname)) == NULL) {
+      free(slot);
+      slot = NULL;
+    } else {
+      slot->nextFetch = now;
+      slot->next = hostSlots;
+      hostSlots = slot;
+    }
+  }
+
+  if (slot != NULL) {
+    // our turn is the later of now and the slot's time
+    if (slot->nextFetch.tv_sec > now.tv_sec
+        || (slot->nextFetch.tv_sec == now.tv_sec
+            && slot->nextFetch.tv_nsec > now.tv_nsec)) {
+      start = slot->nextFetch;
+    }
+    slot->nextFetch = start;
+    addMilliseconds(&slot->nextFetch, politeDelay);
+  } else {
+    // out of memory; be polite the old way
+    addMilliseconds(&start, politeDelay);
+  }
+  pthread_mutex_unlock(&hostLock);
+
+  // sleep until our turn; restart if interrupted by a signal
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &start, NULL) == EINTR) {
+    ;
+  }
+}
+
+/* ********************* addMilliseconds ************************** */
+/* Move the given time ms milliseconds later.
+ */
+static void
+addMilliseconds(struct timespec* time, const int ms)
+{
+  time->tv_sec += ms / 1000;
+  time->tv_nsec += (ms % 1000) * 1000000L;
+  if (time->tv_nsec >= 1000000000L) {
+    time->tv_sec++;
+    time->tv_nsec -= 1000000000L;
+  }
+}
+
+
 /* ***************************************************************** */
 /*
  * removeDotSegments - removes . and .. segments from url paths
@@ -1115,29 +1605,147 @@ fixRelativeURL(char* base, char* rel, size_t len)
 }
 
 
-/* ***************************************************************** */
-/*
- * removeWhitespace - removes whitespace from str
- * @str: char buffer to modify
- *
- * Eliminates whitespace by shifting and condensing all the non-whitespace
- * toward the beginning of the buffer. This does not alter the size of the
- * buffer.
- *
- * Should have no use outside of this file, thus declared static.
+/* ********************* isLetter ************************** */
+/* Is c a letter, as isalpha says in the C locale the TSE runs in?
+ * Only A-Z and a-z are; letterMask must agree, so no byte past ASCII is.
  */
-static void
-removeWhitespace(char* str)
+static inline bool
+isLetter(const char c)
 {
-  char* prev;                              // previous whitespace
-  char* cur;                               // current non-whitespace
+  return (unsigned char)((c | 0x20) - 'a') < 26;
+}
 
-  // start at beginning of str
-  cur = prev = str;
+/* ********************* scanToWord ************************** */
+/* Return the position of the first letter, '<', or '\0' in doc at or after i.
+ * doc holds at least len bytes, and a '\0' at or before len.
+ */
+static size_t
+scanToWord(const char* doc, size_t i, const size_t len)
+{
+#ifdef WEBPAGE_SIMD
+  const __m128i open = _mm_set1_epi8('<');
+  const __m128i zero = _mm_setzero_si128();
+
+  // most bytes of a page are markup; pass over 16 at a time that hold none of the three
+  for (; i + 16 <= len; i += 16) {
+    const __m128i bytes = _mm_loadu_si128((const __m128i*)&doc[i]);
+    const unsigned stops = letterMask(bytes)
+      | _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, open))
+      | _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero));
+    if (stops != 0) {
+      return i + __builtin_ctz(stops);
+    }
+  }
+#endif
+  while (doc[i] != '\0' && doc[i] != '<' && !isLetter(doc[i])) {
+    i++;
+  }
+  return i;
+}
 
-  do {
-    while (isspace(*cur)) cur++;           // consume any whitespace
-  } while ((*prev++ = *cur++));            // condense to front of str
+/* ********************* scanWord ************************** */
+/* Return the position of the first non-letter in doc at or after i,
+ * which may be its '\0'. doc holds at least len bytes, and a '\0' at or before len.
+ */
+static size_t
+scanWord(const char* doc, size_t i, const size_t len)
+{
+#ifdef WEBPAGE_SIMD
+  for (; i + 16 <= len; i += 16) {
+    const unsigned stops = ~letterMask(_mm_loadu_si128((const __m128i*)&doc[i])) & 0xFFFF;
+    if (stops != 0) {
+      return i + __builtin_ctz(stops);
+    }
+  }
+#endif
+  while (isLetter(doc[i])) {
+    i++;
+  }
+  return i;
+}
+
+#ifdef WEBPAGE_SIMD
+/* ********************* letterMask ************************** */
+/* Return a bit for each of the 16 bytes, set if it is a letter, as isLetter says.
+ * Folding to lowercase and shifting 'a' to the smallest signed byte
+ * leaves the letters, and only them, in the 26 smallest values.
+ */
+static inline unsigned
+letterMask(const __m128i bytes)
+{
+  const __m128i lower = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+  const __m128i shifted = _mm_add_epi8(lower, _mm_set1_epi8(128 - 'a'));
+  return _mm_movemask_epi8(_mm_cmplt_epi8(shifted, _mm_set1_epi8(-128 + 26)));
+}
+#endif
+
+/* ********************* isWhite ************************** */
+/* Is c white space, as isspace says in the C locale the TSE runs in? */
+static inline bool
+isWhite(const char c)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/* ********************* skipWhite ************************** */
+/* Return the position of the first char of str at or after i that is not white space. */
+static size_t
+skipWhite(const char* str, size_t i)
+{
+  while (isWhite(str[i])) {
+    i++;
+  }
+  return i;
+}
+
+/* ********************* matchWhite ************************** */
+/* Would pattern match str at i, ignoring case, if the white space were removed from str?
+ * That is, skipping any white space before each char of pattern but the first.
+ * pattern must be lowercase, with no white space.
+ * Return the position just past the match, or 0 if it does not match.
+ */
+static size_t
+matchWhite(const char* str, size_t i, const char* pattern)
+{
+  for (int p = 0; pattern[p] != '\0'; p++) {
+    if (p > 0) {
+      i = skipWhite(str, i);
+    }
+    if (tolower((unsigned char)str[i]) != pattern[p]) {
+      return 0;
+    }
+    i++;
+  }
+  return i;
+}
+
+/* ********************* scanFor ************************** */
+/* Return the position of the first byte of str at or after i that equals c
+ * once or'd with fold, or of its '\0' if none does. fold is 0 to match c exactly,
+ * or 0x20 with a lowercase letter c to match it in either case.
+ * str holds at least len bytes, and a '\0' at or before len.
+ */
+static size_t
+scanFor(const char* str, size_t i, const size_t len, const char c, const char fold)
+{
+#ifdef WEBPAGE_SIMD
+  const __m128i want = _mm_set1_epi8(c);
+  const __m128i folds = _mm_set1_epi8(fold);
+  const __m128i zero = _mm_setzero_si128();
+
+  for (; i + 16 <= len; i += 16) {
+    const __m128i bytes = _mm_loadu_si128((const __m128i*)&str[i]);
+    const unsigned stops = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(bytes, folds), want))
+      | _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero));
+    if (stops != 0) {
+      return i + __builtin_ctz(stops);
+    }
+  }
+#endif
+  while (str[i] != '\0' && (str[i] | fold) != c) {
+    i++;
+  }
+  return i;
 }
 
 /* **************** isBlankLine ******************/
@@ -37,6 +37,7 @@ typedef struct webpage webpage_t;
 int   webpage_getDepth(const webpage_t* page);
 char* webpage_getURL(const webpage_t* page);
 char* webpage_getHTML(const webpage_t* page);
+size_t webpage_getHTMLLength(const webpage_t* page);  // bytes of html, as fetched or given
 
 /**************** webpage_new ****************/
 /* Allocate and initialize a new webpage_t structure.
@@ -84,7 +85,8 @@ void webpage_delete(void* data);
  *
  * We return:
  *   true if the fetch was successful; otherwise, false;
- *   if the fetch succeeded, page->html will contain the content retrieved.
+ *   if the fetch succeeded, page->html will contain the content retrieved,
+ *   and webpage_getHTMLLength its length, as read from the connection.
  *
  * Caller is responsible for:
  *   If this function is successful, a new, null-terminated character
@@ -103,9 +105,45 @@ void webpage_delete(void* data);
  *   * can only handle http (not https or other schemes)
  *   * can only handle URLs of form http://host[:port][/pathname]
  *   * cannot handle redirects (HTTP 301 or 302 response codes)
+ *
+ * Politeness:
+ *   fetches to the same host are spaced at least the politeness delay apart
+ *   (one second, unless changed by webpage_setPoliteness), by sleeping
+ *   until that host's turn; fetches to different hosts do not wait for
+ *   each other.
+ *
+ * Connections:
+ *   we speak HTTP/1.1 with keep-alive, and read the body by its
+ *   Content-Length or chunked transfer encoding, so after a fetch the
+ *   connection can stay open; the next fetch from the same host and port
+ *   reuses it instead of opening a new one.  Servers that close the
+ *   connection, or send neither length nor chunks, still work.
+ *
+ * Threads:
+ *   several threads may call webpage_fetch at once, on different pages.
  */
 bool webpage_fetch(webpage_t* page);
 
+/**************** webpage_setPoliteness ****************/
+/* Set the minimum delay between two fetches from the same host.
+ *
+ * Caller provides:
+ *   milliseconds, the delay; must be >= 0 (we ignore negative values).
+ * We do:
+ *   use that delay for every later webpage_fetch, for every host.
+ */
+void webpage_setPoliteness(const int milliseconds);
+
+/**************** webpage_cleanup ****************/
+/* Free the state webpage_fetch keeps from one fetch to the next:
+ * close the idle connections, and forget the per-host schedule.
+ *
+ * Caller is responsible for:
+ *   calling this once all fetches are done, e.g., at the end of a crawl.
+ *   Later fetches still work, but open new connections.
+ */
+void webpage_cleanup(void);
+
 
 /**************** webpage_getNextWord ***********************************/
 /* return the next word from page->html[pos]
@@ -118,9 +156,6 @@ bool webpage_fetch(webpage_t* page);
  *
  * We return:
  *   pointer to string containing the next word, if any; otherwise NULL.
- * 
- * Side effect:
- *   page->html will be compressed to remove white space.
  *
  * Caller is responsible for:
  *   later free()ing the string returned.
@@ -137,6 +172,37 @@ bool webpage_fetch(webpage_t* page);
 
 char* webpage_getNextWord(webpage_t* page, int* pos);
 
+/**************** webpage_getNextWordSpan *******************************/
+/* find the next word in page->html[pos], without copying it
+ *
+ * Caller provides
+ *   page: pointer to valid webpage_t with page->html not NULL.
+ *   pos: pointer to an int representing current position in html buffer;
+ *        should be 0 on the initial call.
+ *        After return, *pos is the index after the word found.
+ *   length: pointer to an int for the length of the word.
+ *
+ * We return:
+ *   pointer to the first character of the next word in page->html, if any,
+ *   setting *length to its number of characters; otherwise NULL.
+ *   The word is not null-terminated, and is not lowercased; it is the same
+ *   word webpage_getNextWord would return a copy of.
+ *
+ * Caller is responsible for:
+ *   using the word only while the page exists, and not freeing it.
+ *
+ * Usage example: (print all words in a page)
+ * int pos = 0;
+ * int length;
+ * const char* word;
+ *
+ * while ((word = webpage_getNextWordSpan(page, &pos, &length)) != NULL) {
+ *     printf("Found word: %.*s\n", length, word);
+ * }
+ */
+
+const char* webpage_getNextWordSpan(webpage_t* page, int* pos, int* length);
+
 /****************** webpage_getNextURL ***********************************/
 /* return the next url from page->html[pos]
  *
@@ -148,9 +214,8 @@ char* webpage_getNextWord(webpage_t* page, int* pos);
  *
  * We return:
  *   pointer to string containing the next URL, if any; otherwise NULL.
- *
- * Side effect:
- *   page->html will be compressed to remove white space.
+ *   Links are found as if the white space were removed from page->html,
+ *   which is left unchanged; white space in a URL is left out of it.
  *
  * Caller is responsible for:
  *   later free()ing the string returned.
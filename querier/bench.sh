@@ -0,0 +1,63 @@
+#!/bin/bash
+#
+# Bash benchmark script for querier.c
+#
+# usage: bash bench.sh pageDirectory indexFilename numQueries "seeds" resultsFile [baselineFile]
+#
+# For each seed, makes numQueries random queries with myfuzzquery, answers them with
+# querier --batch, and records in resultsFile a checksum of the replies, then the index
+# load time, throughput, latency percentiles and histogram, and peak RSS querier reports.
+# The same seeds give the same queries, so results files from two commits can be diffed:
+# the checksums should match, and the timings show what got faster or slower.
+#
+# Given the resultsFile of an earlier run as baselineFile, also reports every seed whose
+# p50, p95, or p99 latency, or load time, is more than twice the baseline's, and exits 1
+# if there is any.
+
+if [ $# -lt 5 ]; then
+    echo "usage: bash bench.sh pageDirectory indexFilename numQueries \"seeds\" resultsFile [baselineFile]" >&2
+    exit 2
+fi
+pageDirectory=$1
+indexFilename=$2
+numQueries=$3
+seeds=$4
+results=$5
+baseline=$6
+
+queries=$(mktemp)
+replies=$(mktemp)
+trap 'rm -f "$queries" "$replies"' EXIT
+
+echo "# querier benchmark of $pageDirectory $indexFilename, $numQueries queries per seed" > "$results"
+for seed in $seeds; do
+    ./myfuzzquery "$indexFilename" "$numQueries" "$seed" > "$queries" || exit 1
+    echo "seed $seed" >> "$results"
+    ./querier --batch "$queries" "$pageDirectory" "$indexFilename" 2>> "$results" > "$replies" || exit 1
+    echo "replies $(cksum < "$replies")" >> "$results"
+done
+cat "$results"
+
+if [ -n "$baseline" ]; then
+    # pick out the timings of each seed, from the baseline first, and compare
+    awk '
+        FNR == 1    { run = (FILENAME == ARGV[1]) ? "baseline" : "new" }
+        /^seed /    { seed = $2 }
+        /^Load:/    { t[run, seed, "load"] = $2 }
+        /^Latency:/ { t[run, seed, "p50"] = $3; t[run, seed, "p95"] = $6; t[run, seed, "p99"] = $9 }
+        END {
+            for (k in t) {
+                split(k, part, SUBSEP)
+                if (part[1] != "new") {
+                    continue
+                }
+                old = t["baseline", part[2], part[3]]
+                if (old > 0 && t[k] > 2 * old) {
+                    printf("SLOWER: seed %s %s %s, baseline %s\n", part[2], part[3], t[k], old)
+                    slower = 1
+                }
+            }
+            exit slower
+        }
+    ' "$baseline" "$results"
+fi
@@ -4,15 +4,43 @@
  * This is the third module of the TSE for CS50
  * 
  * Querier takes two arguements, a pageDirectory, and an indexFilename
+ *     querier [--top K] [--cache N] [--socket socketPath | --batch queryFile] [-j numThreads]
+ *             pageDirectory indexFilename
+ * K, if given, must be at least 1; only the K best matches of each query are printed.
+ * N, if given, must be at least 1; the ranked results of the N most recently used distinct
+ * queries are cached, and the cache's hits and misses are printed to stderr.
+ * numThreads, if given, must be between 1 and 64; it defaults to 4 with --socket, and 1 with --batch.
  * 
  * Input Specificiations:
  * The pageDirectory must be readable and must have been created by crawler
  * indexFilename must be readbale and must have been created by Indexer for the same pageDirectory
  * 
+ * If indexFilename is a binary index file (indexer -b), it is mapped into memory and queries
+ * are answered from the mapping; otherwise the text index is loaded into an index_t and
+ * frozen into an indexmap in memory. Either way the index is never written once queries start,
+ * so the threads of the server read it at once without locks.
+ * URLs of matching pages come from pageDirectory/.urls (see urltable.h), written by crawler
+ * and indexer, when it exists; otherwise from the first line of each page file.
+ * 
  * The querier then reads user input line by line from stdin, for a valid
  * query it will print a list in descending order of webpages from the given directory
  * that match the query words.
  * 
+ * With --socket, querier instead runs as a server: it loads the index once, listens on a
+ * Unix domain socket at socketPath, and answers clients with numThreads threads that share
+ * the read-only index. A client writes one query per line; for each, the server writes back
+ * what querier would print for it, always ending with the line of dashes. The server runs
+ * until it is killed.
+ * 
+ * With --batch, querier instead reads all the queries in queryFile, answers them with
+ * numThreads threads, and prints one compact line per query, in the order of queryFile:
+ *     queryNumber <tab> number of matches <tab> docID:score docID:score ...
+ * listing the ranked matches without their URLs, or for a blank or invalid query
+ *     queryNumber <tab> Error: why
+ * Queries are numbered from 1. Then it prints to stderr the number of queries answered,
+ * the queries answered per second, and the 50th, 95th, and 99th percentile and the
+ * longest of the times taken to answer one query.
+ * 
  * Input any valid words of at least three characters with 'or' and 'and'
  * as modifiers.
  * 
@@ -21,36 +49,101 @@
  * Jack McMahon, February 21th 2022
  */
 
+#define _POSIX_C_SOURCE 200809L   // for fileno, fdopen, and sockets under -std=c11
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include "../libcs50/mem.h"
 #include "../libcs50/webpage.h"
 #include "../libcs50/counters.h"
 #include "../libcs50/hashtable.h"
 #include "queryToken.h"
+#include "queryCache.h"
 #include "../common/pagedir.h"
 #include "../common/index.h"
+#include "../common/indexmap.h"
+#include "../common/urltable.h"
 #include "../common/word.h"
 
+/**************** global types ****************/
+// the index queries are answered from, which nothing changes once it is set up
+typedef struct queryIndex {
+    indexmap_t* map;            // binary index file mapped into memory, or text index frozen
+    urltable_t* urls;           // URLs of the pages in pageDirectory, or NULL
+    queryCache_t* cache;        // ranked results of recent queries, or NULL
+} queryIndex_t;
+
+// one stream of queries being answered, and where its output goes;
+// many sessions can answer queries at once from the same queryIndex_t
+typedef struct querySession {
+    queryIndex_t* index;        // index shared with other sessions, only read
+    char* pageDirectory;        // directory of the pages in the index
+    int topK;                   // most matches to print per query, or 0 for all
+    FILE* out;                  // where results and errors are printed
+    bool compact;               // whether to print results in the compact batch format
+} querySession_t;
+
+// a query server: the socket its threads accept clients on, and what their sessions share
+typedef struct queryServer {
+    int listenFd;               // listening Unix domain socket
+    queryIndex_t* index;        // index shared by all sessions
+    char* pageDirectory;        // directory of the pages in the index
+    int topK;                   // most matches to print per query, or 0 for all
+} queryServer_t;
+
+// a batch of queries, and what the threads answering them share
+typedef struct queryBatch {
+    queryIndex_t* index;        // index shared by all sessions
+    char* pageDirectory;        // directory of the pages in the index
+    int topK;                   // most matches to print per query, or 0 for all
+    double loadSeconds;         // seconds taken to load or map the index
+    char** queries;             // the queries, in order
+    size_t* lengths;            // length of each query
+    int numQueries;             // number of queries
+    char** replies;             // compact reply to each query
+    double* latencies;          // seconds taken to answer each query
+    int next;                   // next query to answer
+    pthread_mutex_t lock;       // protects next
+} queryBatch_t;
+
+/**************** file-local global variables ****************/
+static const int MAXTHREADS = 64;   // maximum number of server threads
+static const long BACKOFFNS = 100000000;    // nanoseconds to wait for a descriptor before accepting again
+static const char* SEPARATOR = "-----------------------------------------------\n";
+
 // function prototypes
-static void parseArgs(const int argc, char* argv[],
-                      char** pageDirectory, char** indexFilename);
-static void takeQueries(char* pageDirectory, index_t* index);
-static bool parseQuery(counters_t** resultCounter, char* query, index_t* index);
-static queryToken_t* tokenizeQuery(char* query);
-static void intersectSets(counters_t* resultCounter, counters_t* addedCounter);
-static void intersectHelper(void *arg, const int key, const int count);
-static void unionSets(counters_t** resultCounter, counters_t* addedCounter);
-static void unionHelper(void *arg, const int key, const int count);
-static void rankResults(counters_t* resultCounter, char* pageDirectory);
-static void countResults(void *arg, const int key, const int count);
-static void printResults(void *arg, const int key, const int count);
-static void countersZero(void *arg, const int key, const int count);
+static void parseArgs(const int argc, char* argv[], char** pageDirectory, char** indexFilename,
+                      int* topK, int* cacheSize, char** socketPath, char** batchFilename, int* numThreads);
+static void takeQueries(querySession_t* session);
+static void batchQueries(queryBatch_t* batch, const char* batchFilename, const int numThreads);
+static void* batchWorker(void* arg);
+static int compareLatencies(const void* a, const void* b);
+static void printHistogram(const double* sorted, const int numLatencies);
+static void serveQueries(queryServer_t* server, const char* socketPath, const int numThreads);
+static void* serveClients(void* arg);
+static void serveClient(queryServer_t* server, const int fd);
+static bool answerQuery(querySession_t* session, char* query, size_t length);
+static queryToken_t* parseQuery(querySession_t* session, char* query, size_t length);
+static posting_t* evaluateQuery(querySession_t* session, queryToken_t* firstToken, int* numResults);
+static queryToken_t* tokenizeQuery(char* query, size_t length);
+static int intersectPostings(const posting_t* a, const int numA, const posting_t* b, const int numB,
+                             posting_t* result);
+static int unionPostings(posting_t** lists, const int* numPostings, const int numLists, posting_t* result);
+static int rankResults(querySession_t* session, posting_t* results, const int numResults);
+static void printResults(querySession_t* session, posting_t* results, const int numMatches, const int numRanked);
+static int compareRanks(const void* a, const void* b);
+static void siftDown(posting_t* heap, const int size, int i);
 static char* findURL(char* pageDirectory, int docID);
-int fileno(FILE *stream);
 static void prompt(void);
 
 /* ********************* main ************************ */
@@ -58,44 +151,155 @@ int main(const int argc, char* argv[]){
 
     char* pageDirectory; //Directory that we will writefiles to for each crawled webpage
     char* indexFilename; //File name for the index file we will write
-    index_t* index;      //Index to be loaded from indexFilename
+    queryIndex_t index = {NULL, NULL, NULL};  //Index to be mapped or loaded from indexFilename
+    index_t* loaded;     //text index loaded from indexFilename, until it is frozen
     FILE* fp;            //File pointer to read indexFilename
+    int topK = 0;        //most matches to print per query, or 0 for all
+    int cacheSize = 0;   //most queries to cache, or 0 for no cache
+    char* socketPath = NULL;    //where to serve queries, or NULL
+    char* batchFilename = NULL; //file of queries to answer in a batch, or NULL
+    int numThreads = 0;  //number of server or batch threads, or 0 for the default
+    struct timespec start;      //when loading the index began
+    struct timespec end;        //when it ended
 
     //parse arguments to check if they match correct input type, if so assign to variables
-    parseArgs(argc, argv, &pageDirectory, &indexFilename);
+    parseArgs(argc, argv, &pageDirectory, &indexFilename, &topK, &cacheSize,
+              &socketPath, &batchFilename, &numThreads);
 
-    //load index from indexFilename
-    fp = fopen(indexFilename, "r");
-    index_load(&index, fp);
-    fclose(fp);
+    //map index from indexFilename if it is binary, otherwise load it and freeze it
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if((index.map = indexmap_open(indexFilename)) == NULL){
+        fp = fopen(indexFilename, "r");
+        index_load(&loaded, fp);
+        fclose(fp);
+        index.map = indexmap_freeze(loaded);
+        index_delete(loaded, (void(*)(void*))counters_delete);
+    }
+
+    //map the URL table, if the crawler or indexer wrote one
+    index.urls = urltable_open(pageDirectory);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if(cacheSize > 0){
+        index.cache = mem_assert(queryCache_new(cacheSize), "queryCache");
+    }
 
-    //take queries from stdin
-    takeQueries(pageDirectory, index);
+    if(socketPath != NULL){
+        //serve queries to clients of the socket, until killed
+        queryServer_t server = {-1, &index, pageDirectory, topK};
+        serveQueries(&server, socketPath, numThreads > 0 ? numThreads : 4);
+    }
+    else if(batchFilename != NULL){
+        //answer the batch of queries in batchFilename, and report how fast
+        queryBatch_t batch = {&index, pageDirectory, topK,
+                              (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9};
+        batchQueries(&batch, batchFilename, numThreads > 0 ? numThreads : 1);
+        queryCache_print(index.cache, stderr);
+    }
+    else{
+        //take queries from stdin
+        querySession_t session = {&index, pageDirectory, topK, stdout, false};
+        takeQueries(&session);
+        queryCache_print(index.cache, stderr);
+    }
     
     //free memory at the end
     mem_free(pageDirectory);
     mem_free(indexFilename);
-    index_delete(index, (void(*)(void*))counters_delete);
+    indexmap_close(index.map);
+    urltable_close(index.urls);
+    queryCache_delete(index.cache);
 
     exit(0);
 }
 
 /**************** parseArgs ****************/
 /* 
- * Input: char** for page directory, char** for indexFilename
+ * Input: char** for page directory, char** for indexFilename, int* for most matches to print,
+ *        int* for most queries to cache, char** for the socket path, char** for the batch query file,
+ *        int* for the number of server or batch threads
  * 
  * Makes sure arguments match the given specifications, if so then assigns them to variables
+ * The optional --top K, --cache N, --socket socketPath or --batch queryFile, and -j numThreads
+ * come before the two required arguments.
+ * The socket path and query file name are left in argv, not copied.
 */
-static void parseArgs(const int argc, char* argv[],
-                      char** pageDirectory, char** indexFilename){
-    if(argc != 3){
+static void parseArgs(const int argc, char* argv[], char** pageDirectory, char** indexFilename,
+                      int* topK, int* cacheSize, char** socketPath, char** batchFilename, int* numThreads){
+    int arg = 1; //index of the first required argument
+
+    //check for the optional --top K, --cache N, --socket socketPath, --batch queryFile and -j numThreads
+    while(arg < argc && argv[arg][0] == '-'){
+        if(strcmp(argv[arg], "--top") == 0){
+            if(arg + 1 >= argc || (*topK = atoi(argv[arg + 1])) < 1){
+                //throw error if K is missing or not positive
+                fprintf(stderr, "Number of top matches must be at least 1.\n");
+                exit(7);
+            }
+            arg += 2;
+        }
+        else if(strcmp(argv[arg], "--cache") == 0){
+            if(arg + 1 >= argc || (*cacheSize = atoi(argv[arg + 1])) < 1){
+                //throw error if N is missing or not positive
+                fprintf(stderr, "Number of queries to cache must be at least 1.\n");
+                exit(10);
+            }
+            arg += 2;
+        }
+        else if(strcmp(argv[arg], "--socket") == 0){
+            if(arg + 1 >= argc || argv[arg + 1][0] == '\0'
+               || strlen(argv[arg + 1]) >= sizeof(((struct sockaddr_un*)0)->sun_path)){
+                //throw error if the path is missing, or too long for a socket address
+                fprintf(stderr, "Socket path is missing or too long.\n");
+                exit(9);
+            }
+            *socketPath = argv[arg + 1];
+            arg += 2;
+        }
+        else if(strcmp(argv[arg], "--batch") == 0){
+            if(arg + 1 >= argc){
+                //throw error if queryFile is missing
+                fprintf(stderr, "Missing query file for --batch.\n");
+                exit(1);
+            }
+            *batchFilename = argv[arg + 1];
+            arg += 2;
+        }
+        else if(strcmp(argv[arg], "-j") == 0){
+            if(arg + 1 >= argc || (*numThreads = atoi(argv[arg + 1])) < 1 || *numThreads > MAXTHREADS){
+                //throw error if numThreads is missing or out of range
+                fprintf(stderr, "Number of threads must be between 1 and %d.\n", MAXTHREADS);
+                exit(8);
+            }
+            arg += 2;
+        }
+        else{
+            //throw error if unknown option
+            fprintf(stderr, "Unknown option %s.\n", argv[arg]);
+            exit(1);
+        }
+    }
+
+    if(*socketPath != NULL && *batchFilename != NULL){
+        //throw error if asked to both serve and run a batch
+        fprintf(stderr, "Cannot use both --socket and --batch.\n");
+        exit(1);
+    }
+
+    if(*numThreads > 0 && *socketPath == NULL && *batchFilename == NULL){
+        //throw error if asked for threads with nothing to run them
+        fprintf(stderr, "-j needs --socket or --batch.\n");
+        exit(1);
+    }
+
+    if(argc - arg != 2){
         //throw error if incorrect number of arguments
         fprintf(stderr, "Incorrect number of arguments.\n");
         exit(1);
     }
 
-    *pageDirectory = mem_malloc_assert((strlen(argv[1]) + 1), "pageDirectory");
-    strcpy(*pageDirectory, argv[1]);
+    *pageDirectory = mem_malloc_assert((strlen(argv[arg]) + 1), "pageDirectory");
+    strcpy(*pageDirectory, argv[arg]);
 
     if ( ! pagedir_validate(*pageDirectory)) {
         //throw error if can't write in  given page directory
@@ -104,8 +308,8 @@ static void parseArgs(const int argc, char* argv[],
     }
 
     FILE* fp;
-    *indexFilename = mem_malloc_assert((strlen(argv[2]) + 1), "indexFilename");
-    strcpy(*indexFilename, argv[2]);
+    *indexFilename = mem_malloc_assert((strlen(argv[arg + 1]) + 1), "indexFilename");
+    strcpy(*indexFilename, argv[arg + 1]);
 
     //check if the index file specified by indexFilename is writeable
     if((fp = fopen(*indexFilename, "r")) != NULL) {
@@ -121,65 +325,384 @@ static void parseArgs(const int argc, char* argv[],
 
 /**************** takeQueries ****************/
 /* 
-* Input: char* pageDirectory and index_t* index
+* Input: querySession_t* printing to stdout
 * 
-* Prompts the user and reads query input line by line from stdin. 
-* 
-* Calls parseQuery to verify the query and handle internal logic.
-* Then calls rankResults to print a formatted list in descending order of
-* documents in pageDirectory that match the query.
+* Prompts the user and reads query input line by line from stdin,
+* and calls answerQuery on each.
 * 
 * Returns: nothing
 */
-static void takeQueries(char* pageDirectory, index_t* index){
+static void takeQueries(querySession_t* session){
 
     char* query;        // holds user query
+    size_t length;      // length of the query
 
     prompt();
     //read queries line by line until EOF
-    while((query = file_readLine(stdin)) != NULL){
-        counters_t* resultCounter = counters_new();
-        //display prompt if interactive user
-        if(parseQuery(&resultCounter, query, index)){
-            //if query is valid then return a list of ranked results
-            rankResults(resultCounter, pageDirectory);
-        }
+    while((query = file_readLineLen(stdin, &length)) != NULL){
+        answerQuery(session, query, length);
         //free the query and prompt user for more input
-        counters_delete(resultCounter);
-        if (query != NULL){
-            free(query);
-        }
+        free(query);
         prompt();
     }
 }
 
+/**************** batchQueries ****************/
+/* 
+* Input: queryBatch_t* with the index to answer from, name of the query file, number of threads
+* 
+* Reads every query in batchFilename, then runs numThreads batchWorkers to answer them
+* and time each answer, prints the replies in order to stdout, and prints to stderr how
+* long the index took to load, how many queries were answered, at what rate, the percentiles
+* and a histogram of the time each took, and the peak resident memory of the process.
+* Reading the queries is not timed.
+* 
+* Returns: nothing; exits 11 if batchFilename cannot be read, or 13 if no thread can be started
+*/
+static void batchQueries(queryBatch_t* batch, const char* batchFilename, const int numThreads){
+    FILE* fp;                   //the query file
+    int size = 64;              //queries there is room for
+    pthread_t* threads;         //batch threads
+    int started = 0;            //threads started
+    struct timespec start;      //when answering began
+    struct timespec end;        //when answering ended
+    double elapsed;             //seconds spent answering
+    double* sorted;             //latencies, sorted
+    struct rusage usage;        //holds peak resident memory
+    const double percentiles[] = {0.50, 0.95, 0.99};
+
+    if((fp = fopen(batchFilename, "r")) == NULL){
+        fprintf(stderr, "Cannot open %s for reading\n", batchFilename);
+        exit(11);
+    }
+    batch->queries = mem_malloc_assert(size * sizeof(char*), "queries");
+    batch->lengths = mem_malloc_assert(size * sizeof(size_t), "lengths");
+    batch->numQueries = 0;
+    while((batch->queries[batch->numQueries] = file_readLineLen(fp, &batch->lengths[batch->numQueries])) != NULL){
+        if(++batch->numQueries == size){
+            size *= 2;
+            batch->queries = mem_assert(realloc(batch->queries, size * sizeof(char*)), "queries");
+            batch->lengths = mem_assert(realloc(batch->lengths, size * sizeof(size_t)), "lengths");
+        }
+    }
+    fclose(fp);
+    batch->replies = mem_calloc_assert(batch->numQueries + 1, sizeof(char*), "replies");
+    batch->latencies = mem_calloc_assert(batch->numQueries + 1, sizeof(double), "latencies");
+    batch->next = 0;
+    pthread_mutex_init(&batch->lock, NULL);
+
+    //answer them all with numThreads threads
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    threads = mem_malloc_assert(numThreads * sizeof(pthread_t), "threads");
+    for(int t = 0; t < numThreads; t++){
+        if(pthread_create(&threads[t], NULL, batchWorker, batch) != 0){
+            fprintf(stderr, "Could only start %d of %d threads.\n", started, numThreads);
+            break;
+        }
+        started++;
+    }
+    if(started == 0){
+        exit(13);
+    }
+    for(int t = 0; t < started; t++){
+        pthread_join(threads[t], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    for(int i = 0; i < batch->numQueries; i++){
+        fputs(batch->replies[i], stdout);
+    }
+
+    //report the rate, and the latency percentiles by nearest rank
+    sorted = mem_malloc_assert((batch->numQueries + 1) * sizeof(double), "sorted latencies");
+    memcpy(sorted, batch->latencies, batch->numQueries * sizeof(double));
+    qsort(sorted, batch->numQueries, sizeof(double), compareLatencies);
+    fprintf(stderr, "Load: %.3f s\n", batch->loadSeconds);
+    fprintf(stderr, "Batch: %d queries in %.3f s with %d threads, %.1f queries/s\n",
+            batch->numQueries, elapsed, started, elapsed > 0 ? batch->numQueries / elapsed : 0.0);
+    if(batch->numQueries > 0){
+        fprintf(stderr, "Latency:");
+        for(int p = 0; p < sizeof(percentiles) / sizeof(percentiles[0]); p++){
+            int rank = (int)(percentiles[p] * batch->numQueries + 0.999999);
+            fprintf(stderr, " p%.0f %.1f us,", percentiles[p] * 100, sorted[rank > 0 ? rank - 1 : 0] * 1e6);
+        }
+        fprintf(stderr, " max %.1f us\n", sorted[batch->numQueries - 1] * 1e6);
+        printHistogram(sorted, batch->numQueries);
+    }
+    if(getrusage(RUSAGE_SELF, &usage) == 0){
+        fprintf(stderr, "Peak RSS: %ld KB\n", usage.ru_maxrss);
+    }
+
+    for(int i = 0; i < batch->numQueries; i++){
+        free(batch->queries[i]);
+        free(batch->replies[i]);
+    }
+    pthread_mutex_destroy(&batch->lock);
+    mem_free(sorted);
+    mem_free(threads);
+    mem_free(batch->queries);
+    mem_free(batch->lengths);
+    mem_free(batch->replies);
+    mem_free(batch->latencies);
+}
+
+/**************** batchWorker ****************/
+/* 
+* Thread of a batch: takes the next unanswered query of the queryBatch_t* in arg, and
+* answers it in the compact format into a reply of its own, timing how long that takes,
+* until no queries are left.
+*/
+static void* batchWorker(void* arg){
+    queryBatch_t* batch = arg;
+    querySession_t session = {batch->index, batch->pageDirectory, batch->topK, NULL, true};
+    struct timespec start;      //when answering this query began
+    struct timespec end;        //when it ended
+    size_t size;                //bytes in the reply
+    int i;                      //query being answered
+    int prefix;                 //bytes of the reply before the answer
+
+    while(true){
+        pthread_mutex_lock(&batch->lock);
+        i = batch->next++;
+        pthread_mutex_unlock(&batch->lock);
+        if(i >= batch->numQueries){
+            return NULL;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        session.out = mem_assert(open_memstream(&batch->replies[i], &size), "reply");
+        prefix = fprintf(session.out, "%d\t", i + 1);
+        if(!answerQuery(&session, batch->queries[i], batch->lengths[i]) && ftell(session.out) == prefix){
+            fprintf(session.out, "Error: blank query\n");
+        }
+        fclose(session.out);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        batch->latencies[i] = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    }
+}
+
+/**************** compareLatencies ****************/
+/* 
+* qsort order for latencies: shortest first
+*/
+static int compareLatencies(const void* a, const void* b){
+    double first = *(const double*)a;
+    double second = *(const double*)b;
+
+    return first < second ? -1 : first > second;
+}
+
+/**************** printHistogram ****************/
+/* 
+* Input: latencies in seconds, sorted shortest first, and their number
+* 
+* Prints to stderr how many latencies fall in each power-of-two range of microseconds,
+* from the range of the shortest to that of the longest, one range per line.
+* The ranges are fixed, so histograms from different runs line up when compared.
+*/
+static void printHistogram(const double* sorted, const int numLatencies){
+    double bound = 1;           //upper end of the range in microseconds, exclusive
+    int i = 0;                  //first latency not yet counted
+
+    fprintf(stderr, "Histogram:\n");
+    while(i < numLatencies){
+        int count = 0;          //latencies in this range
+        while(i < numLatencies && sorted[i] * 1e6 < bound){
+            count++;
+            i++;
+        }
+        if(count > 0 || bound > sorted[0] * 1e6){
+            fprintf(stderr, "  < %8.0f us: %d\n", bound, count);
+        }
+        bound *= 2;
+    }
+}
+
+/**************** serveQueries ****************/
+/* 
+* Input: queryServer_t* with the index to serve, path of the socket, number of threads
+* 
+* Listens on a Unix domain socket at socketPath, replacing any socket left there by an
+* earlier server, and runs numThreads threads of serveClients that accept clients on it.
+* A client that goes away mid-reply must not kill the server, so SIGPIPE is ignored
+* and writes to it just fail.
+* 
+* Returns: only if the threads all end; exits 9 if the socket cannot be set up,
+* or 13 if no thread can be started
+*/
+static void serveQueries(queryServer_t* server, const char* socketPath, const int numThreads){
+    struct sockaddr_un addr;    //address of the socket
+    pthread_t* threads;         //server threads
+    int started = 0;            //threads started
+
+    signal(SIGPIPE, SIG_IGN);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath);
+    unlink(socketPath);
+
+    if((server->listenFd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0
+       || bind(server->listenFd, (struct sockaddr*)&addr, sizeof(addr)) != 0
+       || listen(server->listenFd, SOMAXCONN) != 0){
+        fprintf(stderr, "Cannot listen on %s: %s\n", socketPath, strerror(errno));
+        exit(9);
+    }
+
+    threads = mem_malloc_assert(numThreads * sizeof(pthread_t), "threads");
+    for(int t = 0; t < numThreads; t++){
+        if(pthread_create(&threads[t], NULL, serveClients, server) != 0){
+            fprintf(stderr, "Could only start %d of %d threads.\n", started, numThreads);
+            break;
+        }
+        started++;
+    }
+    if(started == 0){
+        exit(13);
+    }
+    for(int t = 0; t < started; t++){
+        pthread_join(threads[t], NULL);
+    }
+
+    mem_free(threads);
+    close(server->listenFd);
+    unlink(socketPath);
+}
+
+/**************** serveClients ****************/
+/* 
+* Thread of the server: accepts clients on the server's socket in arg, one at a time,
+* and serves each until it hangs up. Ends only if the socket itself fails.
+* Out of descriptors or buffers, waits BACKOFFNS before accepting again, rather than spinning.
+*/
+static void* serveClients(void* arg){
+    queryServer_t* server = arg;
+    int fd;                     //socket of the client being served
+
+    while(true){
+        if((fd = accept(server->listenFd, NULL, NULL)) < 0){
+            if(errno == EBADF || errno == EINVAL || errno == ENOTSOCK){
+                return NULL;
+            }
+            if(errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM){
+                //out of descriptors for now; wait for a client to hang up and free one
+                struct timespec backoff = {0, BACKOFFNS};
+                nanosleep(&backoff, NULL);
+            }
+            //otherwise the client gave up, or a signal interrupted us
+            continue;
+        }
+        serveClient(server, fd);
+    }
+}
+
+/**************** serveClient ****************/
+/* 
+* Input: queryServer_t* server, and the socket of a client
+* 
+* Reads queries line by line from the client, and answers each on its own session,
+* ending every reply with the separator, even for a blank or invalid query, so the client
+* can tell where each reply ends. Flushes after each reply, and closes the socket at EOF.
+* Then prints the cache's hits and misses so far to stderr, if there is a cache.
+* 
+* Returns: nothing
+*/
+static void serveClient(queryServer_t* server, const int fd){
+    FILE* in;           //queries from the client
+    FILE* out;          //replies to the client
+    int outFd;          //second descriptor for the client, so in and out can be closed apart
+    char* query;        //holds client query
+    size_t length;      //length of the query
+
+    if((outFd = dup(fd)) < 0 || (in = fdopen(fd, "r")) == NULL){
+        if(outFd >= 0){
+            close(outFd);
+        }
+        close(fd);
+        return;
+    }
+    if((out = fdopen(outFd, "w")) == NULL){
+        close(outFd);
+        fclose(in);
+        return;
+    }
+
+    querySession_t session = {server->index, server->pageDirectory, server->topK, out, false};
+    while((query = file_readLineLen(in, &length)) != NULL){
+        if(!answerQuery(&session, query, length)){
+            fputs(SEPARATOR, out);
+        }
+        free(query);
+        if(fflush(out) != 0){
+            //the client has gone away
+            break;
+        }
+    }
+
+    fclose(out);
+    fclose(in);
+    queryCache_print(server->index->cache, stderr);
+}
+
+/**************** answerQuery ****************/
+/* 
+* Input: querySession_t* session, char* query, size_t length of query
+* 
+* Calls parseQuery to verify the query and handle internal logic.
+* If the query is cached, takes its ranked results from the cache; otherwise calls
+* evaluateQuery to combine the postings of its words into the documents that match it,
+* based on the 'or' and 'and' syntax, then rankResults to rank them, and caches them.
+* Then calls printResults to print to the session a formatted list in descending order of
+* documents in its pageDirectory that match the query.
+* 
+* Returns: true if the query was valid and its results printed, false otherwise
+*/
+static bool answerQuery(querySession_t* session, char* query, size_t length){
+    queryToken_t* firstToken;       // first word of the parsed query
+    queryCache_t* cache = session->index->cache;    // cache of ranked results, or NULL
+    char* key = NULL;               // normalized query, to look up in the cache
+    posting_t* results = NULL;      // documents matching the query, ranked
+    int numMatches = 0;             // number of documents matching the query
+    int numRanked = 0;              // number of documents in results to print
+
+    if((firstToken = parseQuery(session, query, length)) == NULL){
+        return false;
+    }
+
+    if(cache != NULL){
+        key = queryToken_toString(firstToken);
+    }
+    if(!queryCache_find(cache, key, &numMatches, &results, &numRanked)){
+        results = evaluateQuery(session, firstToken, &numMatches);
+        numRanked = rankResults(session, results, numMatches);
+        queryCache_insert(cache, key, numMatches, results, numRanked);
+    }
+    printResults(session, results, numMatches, numRanked);
+
+    mem_free(key);
+    mem_free(results);
+    queryToken_delete(firstToken);
+    return true;
+}
+
 /**************** parseQuery ****************/
 /* 
-* Input: char** resultCounter, char* query, and index_t* index
+* Input: querySession_t* session, char* query, size_t length of query
 * 
 * First loops over the characters in a query to filter out bad queries that are blank
 * or contain invalid characters that are not in the alphabet.
 *
 * Then calls tokenizeQuery to receive a linked list of normalized and formatted 
-* queryTokens which it prints back to stdout and checks for valid syntax.
-* 
-* Then loops over every word in the query and combines the query results for documents in the index
-* into a single counterset based on the 'or' and 'and' syntax. Helper methods for union for 'or' and intersect for 'and 
-* iterate of the result and added counterset to combine.
+* queryTokens which it prints back to the session's output and checks for valid syntax.
 *
-* Returns: true if query is valid and result finding is successful, false otherwise
+* Returns: the first queryToken of the query, which the caller must delete,
+* or NULL if the query is blank or invalid
 */
-static bool parseQuery(counters_t** resultCounter, char* query, index_t* index){
+static queryToken_t* parseQuery(querySession_t* session, char* query, size_t length){
     char c;                                         //char used to iterate through query
     bool containsLetters = false;                   //bool tracks if query contains letters 
     queryToken_t* firstToken = NULL;                //first word pointer in a linked list of query token structs
-    queryToken_t* currentToken = NULL;              //first word pointer in a linked list of query token structs
-    queryToken_t* nextToken = NULL;                 //next word pointer in a linked list of query token structs
-    char* word;                                     //temp variable loads word from a given queryToken
-    int length = strlen(query);                     //length of the query
-    counters_t* rightResult = counters_new();       //holds the rightmost running tally of combined counters
-    counters_t* tempCounter;                        //temp variable to load counters for a given word
-    bool orExists = false;                          //bool keeps track of if we've seen an 'or' yet
 
     //verify the query contains only letters and spaces
     for(int i =0; i < length; i++){
@@ -194,127 +717,122 @@ static bool parseQuery(counters_t** resultCounter, char* query, index_t* index){
         }
         else{
             //print offending character and return false to takeQueries
-            printf("Error: bad character '%c' in query\n", c);
-            return false;
+            fprintf(session->out, "Error: bad character '%c' in query\n", c);
+            return NULL;
         }
     }
 
     //Check if query is blank
     if(!containsLetters){
-        return false;
+        return NULL;
     }
 
     //create a linked list of queryTokens for easy parsing
-    firstToken = tokenizeQuery(query);
-    currentToken = firstToken;
-    //print the query back to stdout
-    queryToken_print(currentToken);
-
-    //return false and end search if query has invalid syntax
-    if (!queryToken_checkSyntax(currentToken)){
-        queryToken_delete(currentToken);
-        return false;
+    firstToken = tokenizeQuery(query, length);
+    //print the query back to the session, unless its output is compact
+    if(!session->compact){
+        queryToken_print(firstToken, session->out);
     }
 
-    //Create the counterset for the first word
-    word = queryToken_getWord(currentToken);
-    tempCounter = index_find(index, word);
-    //add it to the result counterset
-    unionSets(resultCounter, tempCounter);
-
-    //loop over each word and either intersect or union countersects 
-    while((nextToken = queryToken_getNext(currentToken)) != NULL ){
-        //first extract the word from the current queryToken
-        currentToken = nextToken;
-        word = queryToken_getWord(currentToken);
-        if(orExists){
-            //if 'or' already exists then we are working with two result countersets and will
-            //be intersecting new words with the rightmost result
-            if((strcmp(word, "or")) == 0 ){
-                //if we reach another 'or', we collapse both result countersets into the left one and start
-                //a new one from the right of the 'or'
-                unionSets(resultCounter, rightResult);
-                nextToken = queryToken_getNext(currentToken);
-                currentToken = nextToken;
-                word = queryToken_getWord(currentToken);
-                tempCounter = index_find(index, word);
-                counters_iterate(rightResult, rightResult, &countersZero);
-                unionSets(&rightResult, tempCounter);
-            }
-            else if((strcmp(word, "and")) == 0 ){
-                //if the word is 'and' then we skip it and intersect the next word into the result counterset
-                nextToken = queryToken_getNext(currentToken);
-                currentToken = nextToken;
-                word = queryToken_getWord(currentToken);
-                tempCounter = index_find(index, word);
-                intersectSets(rightResult, tempCounter);
-            }
-            else{
-                //otherwise intersect the word into the result counterset
-                tempCounter = index_find(index, word);
-                intersectSets(rightResult, tempCounter);
-            }
+    //return NULL and end search if query has invalid syntax
+    if (!queryToken_checkSyntax(firstToken, session->out)){
+        queryToken_delete(firstToken);
+        return NULL;
+    }
+    return firstToken;
+}
+
+/**************** evaluateQuery ****************/
+/* 
+* Input: querySession_t* session, first queryToken of a query with valid syntax, int* numResults
+* 
+* A query is a list of 'or'-separated clauses of words, with optional 'and's between them.
+* A clause matches the documents in all of its words' postings, with the smallest of their counts;
+* the query matches the documents that any clause matches, with the clauses' counts summed.
+* All postings are sorted by docID, so each intersection is one merge of two lists
+* and the union is one k-way merge of all the clauses, without looking up any docID.
+* Each word is resolved to its term ID in the index once, while counting the clauses;
+* the merges then find each word's postings by term ID, without comparing any strings.
+*
+* Returns: the matching documents sorted by docID, which the caller must free,
+* and sets *numResults to their number
+*/
+static posting_t* evaluateQuery(querySession_t* session, queryToken_t* firstToken, int* numResults){
+    queryToken_t* token;                //current queryToken
+    char* word;                         //word of the current queryToken
+    int numClauses = 1;                 //number of 'or'-separated clauses
+    posting_t** clauses;                //documents matching each clause
+    int* numPostings;                   //number of documents matching each clause
+    int numLists = 0;                   //clauses evaluated so far
+    const posting_t* postings;          //postings of a word
+    int num;                            //number of postings of a word
+    int total = 0;                      //documents matching each clause, summed
+    posting_t* results;                 //documents matching the query
+
+    for(token = firstToken; token != NULL; token = queryToken_getNext(token)){
+        word = queryToken_getWord(token);
+        if(strcmp(word, "or") == 0){
+            numClauses++;
         }
-        else{
-            //if 'or' does not yet exist then we are working with one result counterset that has been intersected
-            //with each addition so far
-            if((strcmp(word, "or")) == 0 ){
-                //if we reach 'or' we skip it, set aside the result counterset for later, and start a new result 
-                //to the right of the 'or'
-                orExists = true;
-                nextToken = queryToken_getNext(currentToken);
-                currentToken = nextToken;
-                word = queryToken_getWord(currentToken);
-                tempCounter = index_find(index, word);
-                unionSets(&rightResult, tempCounter);
-            }
-            else if((strcmp(word, "and")) == 0 ){
-                //if the word is 'and' then we skip it and intersect the next word into the result counterset
-                nextToken = queryToken_getNext(currentToken);
-                currentToken = nextToken;
-                word = queryToken_getWord(currentToken);
-                tempCounter = index_find(index, word);
-                intersectSets(*resultCounter, tempCounter);
-            }
-            else{
-                //otherwise intersect the word into the result counterset
-                tempCounter = index_find(index, word);
-                intersectSets(*resultCounter, tempCounter);
-            }
+        else if(strcmp(word, "and") != 0){
+            queryToken_setTermID(token, indexmap_termID(session->index->map, word));
         }
     }
-    if(orExists){
-        //if we've seen an 'or' before then we have two running tallies and need to combine them at the end
-        unionSets(resultCounter, rightResult);
+    clauses = mem_malloc_assert(numClauses * sizeof(posting_t*), "clauses");
+    numPostings = mem_malloc_assert(numClauses * sizeof(int), "numPostings");
+
+    token = firstToken;
+    while(token != NULL){
+        //the first word of a clause starts its list of documents
+        postings = indexmap_postings(session->index->map, queryToken_getTermID(token), &num);
+        clauses[numLists] = mem_malloc_assert((num + 1) * sizeof(posting_t), "clause");
+        if(num > 0){
+            memcpy(clauses[numLists], postings, num * sizeof(posting_t));
+        }
+        numPostings[numLists] = num;
+
+        //intersect each further word of the clause into that list, in place
+        while((token = queryToken_getNext(token)) != NULL
+              && strcmp((word = queryToken_getWord(token)), "or") != 0){
+            if(strcmp(word, "and") != 0){
+                postings = indexmap_postings(session->index->map, queryToken_getTermID(token), &num);
+                numPostings[numLists] = intersectPostings(clauses[numLists], numPostings[numLists],
+                                                          postings, num, clauses[numLists]);
+            }
+        }
+        total += numPostings[numLists];
+        numLists++;
+
+        //skip the 'or' to the first word of the next clause
+        if(token != NULL){
+            token = queryToken_getNext(token);
+        }
     }
 
-    //free queryTokens and the unneeded result counterset
-    counters_delete(rightResult);
-    queryToken_delete(firstToken);
-    
-    return true;
-}
+    //union the clauses into one list
+    results = mem_malloc_assert((total + 1) * sizeof(posting_t), "results");
+    *numResults = unionPostings(clauses, numPostings, numLists, results);
 
-static void countersZero(void *arg, const int key, const int count){
-    if (arg != NULL){
-        counters_t* rightResult = arg;
-        counters_set(rightResult, key, 0);
+    for(int i = 0; i < numLists; i++){
+        mem_free(clauses[i]);
     }
+    mem_free(clauses);
+    mem_free(numPostings);
+    return results;
 }
 
 /**************** tokenizeQuery ****************/
 /* 
-* Input: char* query
+* Input: char* query, size_t length of query
 * 
 * Loops over the characters in a query, picks out words and adds them as new queryTokens in a linked list.
 *
 * Returns: pointer to the first queryToken in the linked list.
 */
-static queryToken_t* tokenizeQuery(char* query){
+static queryToken_t* tokenizeQuery(char* query, size_t length){
     queryToken_t* firstWord;                                                     //holds a pointer to the first queryToken we can return
     queryToken_t* currentWord;                                                      //holds a pointer to the current
     queryToken_t* nextWord;                                                          //holds a pointer to the next queryToken
-    char length = strlen(query);                                                  //length of query
     char* word = mem_malloc_assert(((length + 1)*sizeof(char)), "tokenWord");     //stores the word to add to make a new queryToken
     char charString[2];                                                           //allows us to strcat and strcpy with a single character
     charString[1] = '\0';                                                        //allows us to strcat and strcpy with a single character
@@ -377,137 +895,222 @@ static queryToken_t* tokenizeQuery(char* query){
     return firstWord;
 }
 
-/**************** intersectSets ****************/
+/**************** intersectPostings ****************/
 /* 
-* Input: two countersets
+* Input: two lists of postings sorted by docID, and room for the smaller of them in result
 * 
-* iterates over the result counterset and sets the count for each key as the min of the two countersets for that key.
+* Walks the shorter list, and for each of its docIDs gallops ahead in the longer list:
+* it doubles its step until it passes the docID, then binary searches the last step.
+* That is linear when the lists are about as long as each other, and much less than
+* linear in the longer list when one is much shorter, as with a rare word and a common one.
+* Each docID in both lists goes to result with the smaller of its two counts.
+* result may be the same array as a or b, since it never gets ahead of either.
 *
-* Returns: nothing
+* Returns: the number of postings in result, still sorted by docID
 */
-static void intersectSets(counters_t* resultCounter, counters_t* addedCounter){
-
-    counters_t** twoCounters = mem_malloc_assert((sizeof(counters_t*)*2), "twocounters");
-    
-    twoCounters[0] = resultCounter;
-    twoCounters[1] = addedCounter;
-    counters_iterate(twoCounters[0], twoCounters, intersectHelper);
-
-    mem_free(twoCounters);
+static int intersectPostings(const posting_t* a, const int numA, const posting_t* b, const int numB,
+                             posting_t* result){
+    const posting_t* small = a;     //shorter list
+    int numSmall = numA;            //length of shorter list
+    const posting_t* large = b;     //longer list
+    int numLarge = numB;            //length of longer list
+    int numResult = 0;              //postings in result
+    int low = 0;                    //first posting of large that may match
 
+    if(numA > numB){
+        small = b;
+        numSmall = numB;
+        large = a;
+        numLarge = numA;
+    }
 
-}
+    for(int i = 0; i < numSmall && low < numLarge; i++){
+        int docID = small[i].docID;
+        int step = 1;
+        int high;
 
-/**************** intersectHelper ****************/
-/* 
-* called by counters_iterate to set each key in result as the min of both counters for that key
-*/
-static void intersectHelper(void *arg, const int key, const int count){
+        //gallop until large[high] is at or past docID, or off the end
+        while(low + step < numLarge && large[low + step].docID < docID){
+            low += step;
+            step *= 2;
+        }
+        high = low + step < numLarge ? low + step : numLarge;
 
-    int minCount;
-    counters_t** twoCounters = arg;
+        //binary search for the first posting in large[low..high) at or past docID
+        while(low < high){
+            int mid = low + (high - low) / 2;
+            if(large[mid].docID < docID){
+                low = mid + 1;
+            }
+            else{
+                high = mid;
+            }
+        }
 
-    if(count < counters_get(twoCounters[1], key)){
-        minCount = count;
-    }
-    else{
-        minCount = counters_get(twoCounters[1], key);
+        if(low < numLarge && large[low].docID == docID){
+            int count = small[i].count < large[low].count ? small[i].count : large[low].count;
+            result[numResult].docID = docID;
+            result[numResult].count = count;
+            numResult++;
+            low++;
+        }
     }
-
-    counters_set(twoCounters[0], key, minCount);
-
+    return numResult;
 }
 
-/**************** unionSets ****************/
+/**************** unionPostings ****************/
 /* 
-* Input: two countersets
+* Input: numLists lists of postings sorted by docID, their lengths, and room for all of them in result
 * 
-* iterates over the added counterset and sets the count in the result 
-* for each key as the sum of the two countersets for that key.
+* Merges all the lists at once: each step takes the smallest docID at the front of any list,
+* sums its counts across the lists that have it, and moves those lists past it.
 *
-* Returns: nothing
+* Returns: the number of postings in result, still sorted by docID
 */
-static void unionSets(counters_t** resultCounter, counters_t* addedCounter){
+static int unionPostings(posting_t** lists, const int* numPostings, const int numLists, posting_t* result){
+    int* next = mem_calloc_assert(numLists + 1, sizeof(int), "next");  //front of each list
+    int numResult = 0;              //postings in result
 
-    if(addedCounter != NULL) {
-        counters_t** twoCounters = mem_malloc_assert((sizeof(counters_t*)*2), "twocounters");
-        twoCounters[0] = *resultCounter;
-        twoCounters[1] = addedCounter;
-        counters_iterate(twoCounters[1], twoCounters, unionHelper);
-        mem_free(twoCounters);
-    }
+    while(true){
+        int docID = -1;             //smallest docID at the front of any list
+        int count = 0;              //sum of its counts
 
+        for(int i = 0; i < numLists; i++){
+            if(next[i] < numPostings[i] && (docID < 0 || lists[i][next[i]].docID < docID)){
+                docID = lists[i][next[i]].docID;
+            }
+        }
+        if(docID < 0){
+            break;
+        }
+        for(int i = 0; i < numLists; i++){
+            if(next[i] < numPostings[i] && lists[i][next[i]].docID == docID){
+                count += lists[i][next[i]].count;
+                next[i]++;
+            }
+        }
+        result[numResult].docID = docID;
+        result[numResult].count = count;
+        numResult++;
+    }
+    mem_free(next);
+    return numResult;
 }
 
-/**************** unionHelper ****************/
+/**************** rankResults ****************/
 /* 
-* called by counters_iterate to set each key in result as the sum of both counters for that key
+* Input: querySession_t* session, matching documents and their number
+* 
+* Orders the matching documents to print, in descending order of count,
+* and of docID among equal counts.
+* To print them all, sorts them all. To print only the topK best, keeps the best topK
+* seen so far in a min-heap whose root is the worst of them, then sorts just those;
+* that costs O(n log K) rather than O(n log n), and nothing is spent ordering the rest.
+* Reorders results.
+*
+* Returns: the number of documents at the front of results to print
 */
-static void unionHelper(void *arg, const int key, const int count){
-    
-    counters_t** twoCounters = arg;
-    int sumCount = count + counters_get(twoCounters[0], key);
-    counters_set(twoCounters[0], key, sumCount);
+static int rankResults(querySession_t* session, posting_t* results, const int numResults){
+    const int topK = session->topK;             //most matches to print, or 0 for all
+    int numRanked = numResults;                 //number of documents to print
 
+    if(topK > 0 && topK < numResults){
+        //heapify the first topK, then let each later document that beats the root replace it
+        numRanked = topK;
+        for(int i = numRanked / 2 - 1; i >= 0; i--){
+            siftDown(results, numRanked, i);
+        }
+        for(int i = numRanked; i < numResults; i++){
+            if(compareRanks(&results[i], &results[0]) < 0){
+                results[0] = results[i];
+                siftDown(results, numRanked, 0);
+            }
+        }
+    }
+    qsort(results, numRanked, sizeof(posting_t), compareRanks);
+    return numRanked;
 }
 
-/**************** rankResults ****************/
+/**************** printResults ****************/
 /* 
-* Input: result counterset and char* for pageDirectory path
+* Input: querySession_t* session, ranked documents, how many match the query, and how many to print
 * 
-* Prints the count, docID, and url from pageDirectory for each document match in the result counterset
+* Prints to the session the count, docID, and url from its pageDirectory for the first numRanked
+* ranked documents, taking the url from the urltable, or from the page file if it is not there.
+* If the session's output is compact, prints instead one line with the count of matches, then
+* the docID and score of each of the first numRanked, and no urls.
 *
 * Returns: nothing
 */
-static void rankResults(counters_t* resultCounter, char* pageDirectory){
-    int numDocuments = 0;                       //counter for number of documents matching query
-    int best[] = {-1, 0};                       //int array to track the current highest ranking docID 
-    char* url;                                  //stores url
+static void printResults(querySession_t* session, posting_t* results, const int numMatches, const int numRanked){
+    const char* url;                            //stores url
+    char* pageURL;                              //stores url read from a page file
 
-    //iterate to tally number of documents
-    counters_iterate(resultCounter, &numDocuments, countResults);
+    if(session->compact){
+        //the number of documents, then each docID and its score, on one line
+        fprintf(session->out, "%d\t", numMatches);
+        for(int i = 0; i < numRanked; i++){
+            fprintf(session->out, i == 0 ? "%d:%d" : " %d:%d", results[i].docID, results[i].count);
+        }
+        fputc('\n', session->out);
+        return;
+    }
 
     //header with number of documents before our output
-    printf("Matches (%d) documents (ranked):\n", numDocuments);
+    fprintf(session->out, "Matches (%d) documents (ranked):\n", numMatches);
 
-    //continiously find the best docID and then set it to zero to get the full ranked list in descedning order
-    for(int i = 0; i < numDocuments; i++){
-        best[0] = -1;
-        best[1] = 0;
-        counters_iterate(resultCounter, best, printResults);
-        url = findURL(pageDirectory, best[0]);
-
-        printf("score %5d doc %5d: %s\n", best[1], best[0], url);
-        counters_set(resultCounter, best[0], 0);
-        mem_free(url);
+    for(int i = 0; i < numRanked; i++){
+        pageURL = NULL;
+        if((url = urltable_find(session->index->urls, results[i].docID)) == NULL){
+            url = pageURL = findURL(session->pageDirectory, results[i].docID);
+        }
+        fprintf(session->out, "score %5d doc %5d: %s\n", results[i].count, results[i].docID, url);
+        mem_free(pageURL);
     }
-    if(best[0] < 0){
-        printf("No documents match\n");
+    if(numMatches == 0){
+        fprintf(session->out, "No documents match\n");
     }
-    printf("-----------------------------------------------\n");
+    fputs(SEPARATOR, session->out);
 }
 
-/**************** countResults ****************/
+/**************** compareRanks ****************/
 /* 
-* called by counters_iterate to count total result documents
+* qsort order for ranking postings: higher count first, then lower docID first
 */
-static void countResults(void *arg, const int key, const int count){
-    int* sum = arg;
+static int compareRanks(const void* a, const void* b){
+    const posting_t* first = a;
+    const posting_t* second = b;
 
-    if (sum != NULL && count > 0)
-    (*sum)++;
+    if(first->count != second->count){
+        return first->count > second->count ? -1 : 1;
+    }
+    return first->docID - second->docID;
 }
 
-/**************** printResults ****************/
+/**************** siftDown ****************/
 /* 
-* called by counters_iterate to find the highest scoring docID to print
+* Restores the min-heap of the first size postings, whose root is the worst by compareRanks,
+* below position i, by swapping the posting at i down past any worse child.
 */
-static void printResults(void *arg, const int key, const int count){
-    int* best = arg;
+static void siftDown(posting_t* heap, const int size, int i){
+    posting_t temp;         //posting being moved down
 
-    if(best[1] < count){
-        best[0] = key;
-        best[1] = count;
+    while(true){
+        int worst = i;
+        int child = 2 * i + 1;
+        if(child < size && compareRanks(&heap[child], &heap[worst]) > 0){
+            worst = child;
+        }
+        if(child + 1 < size && compareRanks(&heap[child + 1], &heap[worst]) > 0){
+            worst = child + 1;
+        }
+        if(worst == i){
+            return;
+        }
+        temp = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = temp;
+        i = worst;
     }
 }
 
@@ -0,0 +1,230 @@
+/*
+ * queryCache.c
+ *
+ * queryCache remembers the ranked results of recent queries
+ *
+ * see queryCache.h for more information.
+ *
+ * Entries are found through a table of hash chains, and kept in a list from
+ * most to least recently used, so finding, inserting, and dropping the least
+ * recently used entry each take constant time. The table never grows, since
+ * the cache never holds more than capacity entries.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <pthread.h>
+#include "../libcs50/mem.h"
+#include "../libcs50/hash.h"
+#include "queryCache.h"
+
+/**************** local types ****************/
+typedef struct cacheEntry {
+    char* query;                    // normalized query
+    unsigned long hash;             // full hash of query
+    int numMatches;                 // documents matching the query
+    posting_t* results;             // its ranked postings
+    int numRanked;                  // number of postings in results
+    struct cacheEntry* chain;       // next entry in the same slot
+    struct cacheEntry* newer;       // entry used just after this one, or NULL
+    struct cacheEntry* older;       // entry used just before this one, or NULL
+} cacheEntry_t;
+
+/**************** global types ****************/
+typedef struct queryCache {
+    cacheEntry_t** slots;           // hash chains of entries
+    int numSlots;                   // number of slots
+    int capacity;                   // most entries held
+    int numEntries;                 // entries held
+    cacheEntry_t* newest;           // most recently used entry
+    cacheEntry_t* oldest;           // least recently used entry
+    long hits;                      // finds that found their query
+    long misses;                    // finds that did not
+    pthread_mutex_t lock;           // held by every function
+} queryCache_t;
+
+/**************** local functions ****************/
+static cacheEntry_t* queryCache_lookup(queryCache_t* cache, const char* query, const unsigned long hash);
+static void queryCache_unlink(queryCache_t* cache, cacheEntry_t* entry);
+static void queryCache_pushNewest(queryCache_t* cache, cacheEntry_t* entry);
+static void queryCache_drop(queryCache_t* cache, cacheEntry_t* entry);
+
+/**************** global functions ****************/
+
+/**************** queryCache_new ****************/
+queryCache_t* queryCache_new(const int capacity){
+    if(capacity < 1){
+        return NULL;
+    }
+
+    queryCache_t* cache = mem_malloc(sizeof(queryCache_t));
+    if(cache == NULL){
+        return NULL;
+    }
+    cache->slots = mem_calloc(capacity, sizeof(cacheEntry_t*));
+    if(cache->slots == NULL){
+        mem_free(cache);
+        return NULL;
+    }
+    cache->numSlots = capacity;
+    cache->capacity = capacity;
+    cache->numEntries = 0;
+    cache->newest = cache->oldest = NULL;
+    cache->hits = cache->misses = 0;
+    pthread_mutex_init(&cache->lock, NULL);
+    return cache;
+}
+
+/**************** queryCache_find ****************/
+bool queryCache_find(queryCache_t* cache, const char* query,
+                     int* numMatches, posting_t** results, int* numRanked){
+    cacheEntry_t* entry;            //entry for the query, if any
+
+    if(cache == NULL || query == NULL){
+        return false;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    if((entry = queryCache_lookup(cache, query, hash_jenkins(query, ULONG_MAX))) == NULL){
+        cache->misses++;
+        pthread_mutex_unlock(&cache->lock);
+        return false;
+    }
+    cache->hits++;
+    queryCache_unlink(cache, entry);
+    queryCache_pushNewest(cache, entry);
+
+    *numMatches = entry->numMatches;
+    *numRanked = entry->numRanked;
+    *results = mem_malloc_assert((entry->numRanked + 1) * sizeof(posting_t), "cached results");
+    memcpy(*results, entry->results, entry->numRanked * sizeof(posting_t));
+    pthread_mutex_unlock(&cache->lock);
+    return true;
+}
+
+/**************** queryCache_insert ****************/
+void queryCache_insert(queryCache_t* cache, const char* query,
+                       const int numMatches, const posting_t* results, const int numRanked){
+    unsigned long hash;             //full hash of query
+    cacheEntry_t* entry;            //new entry for the query
+
+    if(cache == NULL || query == NULL || (results == NULL && numRanked > 0)){
+        return;
+    }
+    hash = hash_jenkins(query, ULONG_MAX);
+
+    pthread_mutex_lock(&cache->lock);
+    //another thread may have answered the same query meanwhile
+    if(queryCache_lookup(cache, query, hash) != NULL){
+        pthread_mutex_unlock(&cache->lock);
+        return;
+    }
+    if(cache->numEntries == cache->capacity){
+        queryCache_drop(cache, cache->oldest);
+    }
+
+    entry = mem_malloc_assert(sizeof(cacheEntry_t), "cache entry");
+    entry->query = mem_malloc_assert(strlen(query) + 1, "cached query");
+    strcpy(entry->query, query);
+    entry->hash = hash;
+    entry->numMatches = numMatches;
+    entry->results = mem_malloc_assert((numRanked + 1) * sizeof(posting_t), "cached results");
+    if(numRanked > 0){
+        memcpy(entry->results, results, numRanked * sizeof(posting_t));
+    }
+    entry->numRanked = numRanked;
+
+    entry->chain = cache->slots[hash % cache->numSlots];
+    cache->slots[hash % cache->numSlots] = entry;
+    queryCache_pushNewest(cache, entry);
+    cache->numEntries++;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/**************** queryCache_print ****************/
+void queryCache_print(queryCache_t* cache, FILE* fp){
+    if(cache == NULL || fp == NULL){
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    long lookups = cache->hits + cache->misses;
+    fprintf(fp, "Cache: %ld hits, %ld misses (%.1f%% hits), %d of %d queries cached\n",
+            cache->hits, cache->misses, lookups == 0 ? 0.0 : 100.0 * cache->hits / lookups,
+            cache->numEntries, cache->capacity);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/**************** queryCache_delete ****************/
+void queryCache_delete(queryCache_t* cache){
+    if(cache != NULL){
+        while(cache->oldest != NULL){
+            queryCache_drop(cache, cache->oldest);
+        }
+        pthread_mutex_destroy(&cache->lock);
+        mem_free(cache->slots);
+        mem_free(cache);
+    }
+}
+
+/**************** queryCache_lookup ****************/
+/* Return the entry for query, whose full hash is given, or NULL if it is not cached. */
+static cacheEntry_t* queryCache_lookup(queryCache_t* cache, const char* query, const unsigned long hash){
+    for(cacheEntry_t* entry = cache->slots[hash % cache->numSlots]; entry != NULL; entry = entry->chain){
+        if(entry->hash == hash && strcmp(entry->query, query) == 0){
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**************** queryCache_unlink ****************/
+/* Take entry out of the list of entries by use; it stays in its hash chain. */
+static void queryCache_unlink(queryCache_t* cache, cacheEntry_t* entry){
+    if(entry->newer != NULL){
+        entry->newer->older = entry->older;
+    }
+    else{
+        cache->newest = entry->older;
+    }
+    if(entry->older != NULL){
+        entry->older->newer = entry->newer;
+    }
+    else{
+        cache->oldest = entry->newer;
+    }
+}
+
+/**************** queryCache_pushNewest ****************/
+/* Put entry at the most recently used end of the list of entries by use. */
+static void queryCache_pushNewest(queryCache_t* cache, cacheEntry_t* entry){
+    entry->newer = NULL;
+    entry->older = cache->newest;
+    if(cache->newest != NULL){
+        cache->newest->newer = entry;
+    }
+    else{
+        cache->oldest = entry;
+    }
+    cache->newest = entry;
+}
+
+/**************** queryCache_drop ****************/
+/* Take entry out of the cache, and free it. */
+static void queryCache_drop(queryCache_t* cache, cacheEntry_t* entry){
+    cacheEntry_t** link = &cache->slots[entry->hash % cache->numSlots];
+
+    while(*link != entry){
+        link = &(*link)->chain;
+    }
+    *link = entry->chain;
+    queryCache_unlink(cache, entry);
+    cache->numEntries--;
+
+    mem_free(entry->query);
+    mem_free(entry->results);
+    mem_free(entry);
+}
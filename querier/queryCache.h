@@ -0,0 +1,77 @@
+/*
+ * queryCache.h
+ *
+ * queryCache remembers the ranked results of recent queries, so that a repeated
+ * query is answered without evaluating or ranking it again.
+ *
+ * Queries are keyed on their normalized words, as queryToken_toString gives them,
+ * so queries differing only in spacing or capitalization share an entry.
+ * The cache holds at most a fixed number of queries; when it is full, adding
+ * another drops the one least recently used. It counts hits and misses, to help
+ * choose its capacity. Every function locks the cache, so threads may share one.
+ */
+
+#ifndef __QUERYCACHE_H
+#define __QUERYCACHE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "../common/indexmap.h"
+
+/**************** global types ****************/
+typedef struct queryCache queryCache_t;
+
+/**************** global functions ****************/
+
+/**************** queryCache_new ****************/
+/* Create a new, empty queryCache holding at most capacity queries
+ *
+ * We return:
+ *   pointer to a new queryCache, or NULL if capacity is less than 1 or error
+ * Caller is responsible for:
+ *   later calling queryCache_delete
+ */
+queryCache_t* queryCache_new(const int capacity);
+
+/**************** queryCache_find ****************/
+/* Look up the results of a query, counting a hit or a miss
+ * Caller Provides:
+ *          valid queryCache, normalized query, and pointers for the results
+ * We return:
+ *         true on a hit, setting *numMatches to the number of documents matching
+ *         the query, *results to a copy of its ranked postings, and *numRanked to
+ *         their number; false on a miss, leaving them alone
+ * Caller is responsible for:
+ *         freeing *results after a hit, with mem_free
+ */
+bool queryCache_find(queryCache_t* cache, const char* query,
+                     int* numMatches, posting_t** results, int* numRanked);
+
+/**************** queryCache_insert ****************/
+/* Remember the results of a query, making it the most recently used,
+ * and dropping the least recently used query if the cache is full
+ * Caller Provides:
+ *          valid queryCache, normalized query, the number of documents matching it,
+ *          and its ranked postings and their number
+ * Notes:
+ *          the cache keeps its own copies of query and results;
+ *          a query already in the cache keeps its old results
+ */
+void queryCache_insert(queryCache_t* cache, const char* query,
+                       const int numMatches, const posting_t* results, const int numRanked);
+
+/**************** queryCache_print ****************/
+/* Print one line with the hits, misses, and size of the cache
+ * Caller Provides:
+ *          queryCache (may be NULL, printing nothing), and the file to print to
+ */
+void queryCache_print(queryCache_t* cache, FILE* fp);
+
+/**************** queryCache_delete ****************/
+/* Delete the cache and everything in it
+ * Caller Provides:
+ *          queryCache (may be NULL)
+ */
+void queryCache_delete(queryCache_t* cache);
+
+#endif // __QUERYCACHE_H
@@ -18,6 +18,7 @@
 /**************** global types ****************/
 typedef struct queryToken {
     char* word;               // pointer to word
+    int termID;               // term ID of word in the index, or -1
     struct queryToken *next;  // link to next queryToken
 }   queryToken_t;
 
@@ -37,6 +38,7 @@ queryToken_t* queryToken_new(char* word){
     } else {
       // initialize contents of queryToken structure
       token->word = localWord;
+      token->termID = -1;
       token->next = NULL;
       return token;
     }
@@ -52,29 +54,60 @@ char* queryToken_getWord(queryToken_t* token){
     return token->word;
 }
 
+/**************** queryToken_setTermID ****************/
+void queryToken_setTermID(queryToken_t* token, const int termID){
+    token->termID = termID;
+}
+
+/**************** queryToken_getTermID ****************/
+int queryToken_getTermID(queryToken_t* token){
+    return token->termID;
+}
+
 /**************** queryToken_getNext ****************/
 queryToken_t* queryToken_getNext(queryToken_t* token){
     return token->next;
 }
 
 /**************** queryToken_print ****************/
-void queryToken_print(queryToken_t* token){
+void queryToken_print(queryToken_t* token, FILE* fp){
     queryToken_t* currentToken = token;
     queryToken_t* nextToken;
     char* word = queryToken_getWord(currentToken);
     if(word != NULL){
-      printf("Query: %s", word);
+      fprintf(fp, "Query: %s", word);
     }
     while((nextToken = queryToken_getNext(currentToken)) != NULL ){
       word = queryToken_getWord(nextToken);
-      printf(" %s", word);
+      fprintf(fp, " %s", word);
       currentToken = nextToken;
     }
-    printf("\n");
+    fprintf(fp, "\n");
+}
+
+/**************** queryToken_toString ****************/
+char* queryToken_toString(queryToken_t* token){
+    size_t length = 0;
+    char* string;
+
+    for(queryToken_t* current = token; current != NULL; current = current->next){
+      length += strlen(current->word) + 1;
+    }
+    string = mem_malloc_assert(length + 1, "query string");
+    length = 0;
+    for(queryToken_t* current = token; current != NULL; current = current->next){
+      if(length > 0){
+        string[length++] = ' ';
+      }
+      strcpy(string + length, current->word);
+      length += strlen(current->word);
+    }
+    string[length] = '\0';
+    return string;
 }
 
 /**************** queryToken_checkSyntax ****************/
-bool queryToken_checkSyntax(queryToken_t* token){
+bool queryToken_checkSyntax(queryToken_t* token, FILE* fp){
     queryToken_t* currentToken = token;
     queryToken_t* nextToken;
     char* word = queryToken_getWord(currentToken);
@@ -83,7 +116,7 @@ bool queryToken_checkSyntax(queryToken_t* token){
 
     //check if the first word is 'and' or 'or'
     if((strcmp(word, "and")) == 0 ||(strcmp(word, "or")) == 0 ){
-      printf("Error: '%s' cannot be first\n", word);
+      fprintf(fp, "Error: '%s' cannot be first\n", word);
       return false;
     }
     //loop over the interior words to check if 'and' or 'or'  are adjacent
@@ -91,11 +124,11 @@ bool queryToken_checkSyntax(queryToken_t* token){
       word = queryToken_getWord(nextToken);
       if((strcmp(word, "and")) == 0 ){
           if(lastAnd){
-              printf("Error: 'and' and 'and' cannot be adjacent\n");
+              fprintf(fp, "Error: 'and' and 'and' cannot be adjacent\n");
               return false;
           }
           else if(lastOr){
-              printf("Error: 'or' and 'and' cannot be adjacent\n");
+              fprintf(fp, "Error: 'or' and 'and' cannot be adjacent\n");
               return false;
           }
           lastAnd = true;
@@ -103,11 +136,11 @@ bool queryToken_checkSyntax(queryToken_t* token){
       }
       else if((strcmp(word, "or")) == 0 ){
           if(lastAnd){
-              printf("Error: 'and' and 'or' cannot be adjacent\n");
+              fprintf(fp, "Error: 'and' and 'or' cannot be adjacent\n");
               return false;
           }
           else if(lastOr){
-              printf("Error: 'or' and 'or' cannot be adjacent\n");
+              fprintf(fp, "Error: 'or' and 'or' cannot be adjacent\n");
               return false;
           }
           lastAnd = true;
@@ -121,7 +154,7 @@ bool queryToken_checkSyntax(queryToken_t* token){
     } 
     //now check if the last word is 'and' or 'or'
     if((strcmp(word, "and")) == 0 ||(strcmp(word, "or")) == 0 ){
-      printf("Error: '%s' cannot be last\n", word);
+      fprintf(fp, "Error: '%s' cannot be last\n", word);
       return false;
     }
     return true;
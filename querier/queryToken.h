@@ -46,6 +46,20 @@ void queryToken_addNext(queryToken_t* token, queryToken_t* nextToken);
  */
 char* queryToken_getWord(queryToken_t* token);
 
+/**************** queryToken_setTermID ****************/
+/* Remember the term ID of the word stored in a specified queryToken,
+ * so it is looked up in the index only once
+ * We return:
+ *   nothing
+ */
+void queryToken_setTermID(queryToken_t* token, const int termID);
+
+/**************** queryToken_getTermID ****************/
+/* We return:
+ *   int term ID set by queryToken_setTermID, or -1 if none was set
+ */
+int queryToken_getTermID(queryToken_t* token);
+
 /**************** queryToken_getNext ****************/
 /* We return:
  *   pointer to the queryToken stored in token->next
@@ -54,19 +68,30 @@ queryToken_t* queryToken_getNext(queryToken_t* token);
 
 /**************** queryToken_print ****************/
 /* Iterate through the linked list and print each stored word with single spaces between
+ * Caller Provides:
+ *          head queryToken of the linked list, and the file to print to
+ */
+void queryToken_print(queryToken_t* token, FILE* fp);
+
+/**************** queryToken_toString ****************/
+/* Join the words of the linked list into one string, with single spaces between,
+ * as queryToken_print prints them
  * Caller Provides:
  *          head queryToken of the linked list
+ * We return:
+ *         the new string, which the caller must free with mem_free
  */
-void queryToken_print(queryToken_t* token);
+char* queryToken_toString(queryToken_t* token);
 
 /**************** queryToken_checkSyntax ****************/
-/* Iterate through the linked list and verify syntax matches specifications
+/* Iterate through the linked list and verify syntax matches specifications,
+ * printing any error to fp
  * Caller Provides:
- *          head queryToken of the linked list
+ *          head queryToken of the linked list, and the file to print errors to
  * We return:
  *         true if syntax is correct, false if otherwise
  */
-bool queryToken_checkSyntax(queryToken_t* token);
+bool queryToken_checkSyntax(queryToken_t* token, FILE* fp);
 
 /**************** queryToken_delete ****************/
 /* Iterate through the linked list and delete each queryToken and char* word
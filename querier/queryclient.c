@@ -0,0 +1,92 @@
+/*
+ * queryclient.c
+ *
+ * A client of querier's server mode, for testing.sh.
+ * It takes one argument, the path of the socket querier --socket listens on:
+ *     queryclient socketPath
+ *
+ * Queryclient connects to the socket, writes all of stdin to it, one query per line,
+ * then shuts down its side of the connection, so querier knows there are no more queries,
+ * and copies every reply to stdout until querier hangs up.
+ *
+ * Exits 0 if it got to the end of the replies, 1 for bad arguments,
+ * and 2 if it cannot connect, or the connection fails.
+ */
+
+#define _POSIX_C_SOURCE 200809L   // for sockets under -std=c11
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// function prototypes
+static int connectTo(const char* socketPath);
+static int copy(const int from, const int to);
+
+/* ********************* main ************************ */
+int main(const int argc, char* argv[]){
+    int fd;                     //socket connected to querier
+
+    if(argc != 2 || strlen(argv[1]) >= sizeof(((struct sockaddr_un*)0)->sun_path)){
+        fprintf(stderr, "usage: queryclient socketPath\n");
+        exit(1);
+    }
+    if((fd = connectTo(argv[1])) < 0){
+        fprintf(stderr, "Cannot connect to %s\n", argv[1]);
+        exit(2);
+    }
+
+    //send every query, then tell querier there are no more, and read every reply
+    if(copy(STDIN_FILENO, fd) != 0 || shutdown(fd, SHUT_WR) != 0 || copy(fd, STDOUT_FILENO) != 0){
+        fprintf(stderr, "Connection to %s failed\n", argv[1]);
+        close(fd);
+        exit(2);
+    }
+    close(fd);
+    exit(0);
+}
+
+/**************** connectTo ****************/
+/*
+* Input: path of a Unix domain socket, which fits in a socket address
+* Returns: a socket connected to it, or -1 if it cannot connect
+*/
+static int connectTo(const char* socketPath){
+    struct sockaddr_un address;     //address of the socket
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if(fd < 0){
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath);
+    if(connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0){
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**************** copy ****************/
+/*
+* Input: file descriptors to read from and to write to
+* Copies everything from one to the other, until the end of what is read.
+* Returns: 0 if it got to the end, -1 if a read or write failed
+*/
+static int copy(const int from, const int to){
+    char buffer[8192];              //bytes read, not yet written
+    ssize_t numRead;                //bytes in buffer
+
+    while((numRead = read(from, buffer, sizeof(buffer))) > 0){
+        for(ssize_t done = 0, n; done < numRead; done += n){
+            if((n = write(to, buffer + done, numRead - done)) < 0){
+                return -1;
+            }
+        }
+    }
+    return numRead == 0 ? 0 : -1;
+}
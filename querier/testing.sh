@@ -32,6 +32,30 @@ myvalgrind='valgrind --leak-check=full --show-leak-kinds=all'
 
 ./querier output/wikipedia-1 non-existant-path/index-data/test6.index
 
+#7: Test with invalid number of top matches
+
+./querier --top 0 output/wikipedia-1 output/wikipedia-1.index
+
+#8: Test with invalid number of server threads
+
+./querier --socket /tmp/querier-test.sock -j 0 output/wikipedia-1 output/wikipedia-1.index
+
+#9: Test with invalid number of queries to cache
+
+./querier --cache 0 output/wikipedia-1 output/wikipedia-1.index
+
+#10: Test with both a socket and a batch
+
+./querier --socket /tmp/querier-test.sock --batch testInputs/input2 output/wikipedia-1 output/wikipedia-1.index
+
+#11: Test with a nonexistent batch query file
+
+./querier --batch testInputs/nonexistent output/wikipedia-1 output/wikipedia-1.index
+
+#12: Test with a number of threads, but neither a socket nor a batch
+
+./querier -j 4 output/wikipedia-1 output/wikipedia-1.index
+
 #***************Testing Basic Query Inputs****************************
 
 #1: Test with different invalid queries
@@ -42,6 +66,60 @@ myvalgrind='valgrind --leak-check=full --show-leak-kinds=all'
 
 ./querier output/toscrape-2 output/toscrape-2.index < testInputs/input2
 
+#3: Test with a binary index file of toscrape-2, which should match test 2
+
+../indexer/indexer -b output/toscrape-2 output/toscrape-2.bin
+
+./querier output/toscrape-2 output/toscrape-2.bin < testInputs/input2
+
+#4: Test with only the top 3 matches of test 2
+
+./querier --top 3 output/toscrape-2 output/toscrape-2.index < testInputs/input2
+
+#5: Test serving test 2 over a socket to four clients at once; each should get the output of test 2
+
+rm -f /tmp/querier-test.sock
+./querier --socket /tmp/querier-test.sock -j 4 output/toscrape-2 output/toscrape-2.index &
+until [ -S /tmp/querier-test.sock ]; do sleep 0.1; done
+for i in 1 2 3 4; do
+    ./queryclient /tmp/querier-test.sock < testInputs/input2 > testing-client-$i.out &
+done
+wait %2 %3 %4 %5
+cmp testing-client-1.out testing-client-2.out && cmp testing-client-1.out testing-client-3.out \
+    && cmp testing-client-1.out testing-client-4.out && echo "replies match" && cat testing-client-1.out
+kill %1
+
+#6: Test test 2 twice with a cache of 8 queries; the second half should match the first, with 8 misses then 8 hits
+
+(cat testInputs/input2; echo; cat testInputs/input2) | ./querier --cache 8 output/toscrape-2 output/toscrape-2.index
+
+#7: Test test 1 and test 2 in batches, with one thread and with four; the replies should match
+
+./querier --batch testInputs/input1 output/toscrape-1 output/toscrape-1.index
+
+./querier --batch testInputs/input2 output/toscrape-2 output/toscrape-2.index > testing-batch-1.out
+
+./querier --batch testInputs/input2 -j 4 output/toscrape-2 output/toscrape-2.index > testing-batch-4.out
+
+cmp testing-batch-1.out testing-batch-4.out && cat testing-batch-1.out
+
+#8: Test a copy of the binary index of test 3 whose middle term points past the end of the file; querier should reject
+#   the mapping rather than read out of bounds, and exit normally
+
+cp output/toscrape-2.bin output/toscrape-2-corrupt.bin
+numWords=$(od -An -tu4 -j8 -N4 output/toscrape-2.bin | tr -d ' ')
+printf '\377\377\377\177' | dd of=output/toscrape-2-corrupt.bin bs=1 seek=$((24 + 16 * (numWords / 2))) conv=notrunc 2> /dev/null
+./querier output/toscrape-2 output/toscrape-2-corrupt.bin < testInputs/input2 > /dev/null
+echo "querier exited $?"
+
+#9: Test a copy of toscrape-2 whose .urls file gives docID 1 a URL past the end of the file; querier should ignore
+#   the URL table and read URLs from the page files, so the output should match test 2
+
+rm -rf output/toscrape-2-corrupt
+cp -r output/toscrape-2 output/toscrape-2-corrupt
+printf '\377\377\377\177' | dd of=output/toscrape-2-corrupt/.urls bs=1 seek=16 conv=notrunc 2> /dev/null
+./querier output/toscrape-2-corrupt output/toscrape-2.index < testInputs/input2
+
 #***************Testing Valgrind****************************
 
 #1: Test with valgrind 1